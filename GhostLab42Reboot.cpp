@@ -9,10 +9,21 @@
 #include <Wire.h>
 #include "GhostLab42Reboot.h"
 
-// Each I2C has a unique bus address
-#define IS31FL3730_DIGIT_4_I2C_ADDRESS  0x63  // 4 digit IS31FL3730 display
-#define IS31FL3730_DIGIT_4S_I2C_ADDRESS 0x61  // 4 digit IS31FL3730 display (smaller)
-#define IS31FL3730_DIGIT_6_I2C_ADDRESS  0x60  // 6 digit IS31FL3730 display
+// Bus that the library uses unless it is given a different one
+static GhostLab42RebootWireBus defaultBus;
+
+// The boards in the Reboot board set, indexed by display ID
+// These all go on the library's bus
+const GhostLab42RebootBoard rebootBoards[GHOSTLAB42REBOOT_DISPLAY_COUNT] =
+{
+  {GhostLab42RebootKitBoard<0>::address, GhostLab42RebootKitBoard<0>::digits, NULL},
+  {GhostLab42RebootKitBoard<1>::address, GhostLab42RebootKitBoard<1>::digits, NULL},
+  {GhostLab42RebootKitBoard<2>::address, GhostLab42RebootKitBoard<2>::digits, NULL}
+};
+
+// Segments for the minus sign and the decimal point (gfedcba format)
+const byte minusSegments = 0x40;
+const byte decimalSegment = 0x80;
 
 // "Matrix 1 Data Register" index in the IS31FL3730
 // 8-bit value to define which segments are lit.
@@ -33,6 +44,13 @@ const byte IS31FL3730_Lighting_Effect_Register = 0x0D;
 // The PWM Register can modulate LED light at 128 different points
 const byte IS31FL3730_PWM_Register = 0x19;
 
+// Value of the PWM Register after a reset (full brightness)
+const byte IS31FL3730_PWM_Default = 0x80;
+
+// Placeholder for a PWM Register value that we don't know
+// The PWM Register only goes up to 0x80, so this can never be written
+const byte PWM_UNKNOWN = 0xFF;
+
 // "Reset Register" index in the IS31FL3730
 // Once user writes any 8-bit data to the Reset Register, IS31FL3730 will reset
 // all registers to default value
@@ -56,318 +74,2224 @@ const byte lightCorrectionTable[] =
     0x73, 0x76, 0x79, 0x7D, 0x80
 };
 
-/******************************************************************************
- *                                Constructor                                 *
- ******************************************************************************/
+// Segment lookup table for the printable ASCII characters (gfedcba format)
+// Indexed directly by the character so encoding takes constant time. Lives
+// in flash (PROGMEM) so it does not eat into the Arduino's tiny RAM.
+// The low byte is the digit for the character. Characters that need two
+// digits (M and W) keep the leading digit in the high byte.
+// Anything without an entry is written as a blank digit.
+const uint16_t glyphTable[128] PROGMEM =
+{
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, // 0x00 - 0x07
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, // 0x08 - 0x0F
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, // 0x10 - 0x17
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, // 0x18 - 0x1F
+    0x0000, 0x0082, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, // 0x20 - 0x27
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0040, 0x0000, 0x0000, // 0x28 - 0x2F
+    0x003F, 0x0006, 0x005B, 0x004F, 0x0066, 0x006D, 0x007D, 0x0007, // 0x30 - 0x37
+    0x007F, 0x006F, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00A3, // 0x38 - 0x3F
+    0x0000, 0x0077, 0x007C, 0x0039, 0x005E, 0x0079, 0x0071, 0x003D, // 0x40 - 0x47
+    0x0076, 0x0006, 0x001E, 0x0076, 0x0038, 0x3327, 0x0054, 0x003F, // 0x48 - 0x4F
+    0x0073, 0x0067, 0x0050, 0x006D, 0x0078, 0x003E, 0x003E, 0x3C1E, // 0x50 - 0x57
+    0x0076, 0x006E, 0x005B, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, // 0x58 - 0x5F
+    0x0000, 0x0077, 0x007C, 0x0039, 0x005E, 0x0079, 0x0071, 0x003D, // 0x60 - 0x67
+    0x0076, 0x0006, 0x001E, 0x0076, 0x0038, 0x3327, 0x0054, 0x003F, // 0x68 - 0x6F
+    0x0073, 0x0067, 0x0050, 0x006D, 0x0078, 0x003E, 0x003E, 0x3C1E, // 0x70 - 0x77
+    0x0076, 0x006E, 0x005B, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000  // 0x78 - 0x7F
+};
 
-GhostLab42Reboot::GhostLab42Reboot(){}
+// Runs the API hooks from GhostLab42RebootConfig.h around a public function,
+// nothing at all unless they have been filled in
+class ApiHook
+{
+  public:
+    ApiHook() { GHOSTLAB42REBOOT_API_BEGIN(); }
+    ~ApiHook() { GHOSTLAB42REBOOT_API_END(); }
+};
 
+#if GHOSTLAB42REBOOT_TRACE_LENGTH > 0
 /*
- * Acts as the Constructor
+ * Writes a 32 bit value to the trace dump, least significant byte first
  *
- * Would have liked to just use the constructor, but you can't call
- * Wire.begin there :-/
+ * Parameters:
+ * out   Where to write it
+ * value The value to write
  */
-void GhostLab42Reboot::begin()
+static size_t writeTraceLong(Print &out, unsigned long value)
 {
-    Wire.begin();
+  size_t written = 0;
+  for (byte i = 0; i < 4; i++)
+  {
+    written += out.write((byte)(value >> (8 * i)));
+  }
+  return written;
+}
+#endif
 
-    // Set the maximum display power for all of the displays
-    setDisplayPowerMax(0);
-    setDisplayPowerMax(1);
-    setDisplayPowerMax(2);
+/*
+ * Waits for any number of microseconds
+ *
+ * delayMicroseconds() is only accurate up to 16383 microseconds and takes an
+ * unsigned int, so longer waits go through delay() for the milliseconds
+ *
+ * Parameters:
+ * microseconds How long to wait
+ */
+static void waitMicroseconds(unsigned long microseconds)
+{
+  if (microseconds >= 16384)
+  {
+    delay(microseconds / 1000);
+    microseconds %= 1000;
+  }
+  delayMicroseconds(microseconds);
 }
 
+#if GHOSTLAB42REBOOT_STATS
+// Adds the time from when it is created until it goes out of scope to the
+// latency histogram of a display
+class LatencyTimer
+{
+  public:
+    LatencyTimer(GhostLab42RebootStats &stats) : stats(stats), start(micros()) {}
+
+    ~LatencyTimer()
+    {
+      // Bucket n holds the calls that took 2^(n-1) to 2^n - 1 microseconds
+      unsigned long elapsed = micros() - start;
+      byte bucket = 0;
+      while (elapsed > 0 && bucket < GHOSTLAB42REBOOT_LATENCY_BUCKETS - 1)
+      {
+        elapsed >>= 1;
+        bucket++;
+      }
+      if (stats.latency[bucket] < 0xFFFF) stats.latency[bucket]++;
+    }
+  private:
+    GhostLab42RebootStats &stats;
+    unsigned long start;
+};
+#endif
+
 /******************************************************************************
- *                              Public Functions                              *
+ *                                Constructor                                 *
  ******************************************************************************/
 
+GhostLab42Reboot::GhostLab42Reboot() : printSink(*this)
+{
+  init(defaultBus);
+}
+
 /*
- * Writes the characters to the selected display. The only characters allowed
- * are numbers 0-9 and letters A, b, C, d, E, and F
+ * Parameters:
+ * bus Where to send the transactions to the displays, ex. a
+ *     GhostLab42RebootWireBus for a different Wire instance, or a
+ *     GhostLab42RebootRecordingBus to see what is being sent
  */
-void GhostLab42Reboot::write(int displayID, String value)
+GhostLab42Reboot::GhostLab42Reboot(GhostLab42RebootBus &bus) : printSink(*this)
 {
-  // Verify the display exists before attempting to write to it
-  if (verifyDisplayID(displayID) == false) return;
+  init(bus);
+}
 
-  // Make sure the maximum current for the display is not exceeded
-  setDisplayPowerMax(displayID);
+/*
+ * Sets everything up for the constructors
+ *
+ * Parameters:
+ * bus Where to send the transactions to the displays
+ */
+void GhostLab42Reboot::init(GhostLab42RebootBus &bus)
+{
+  this->bus = &bus;
 
-  // Write the display data in the temporary registers
-  setupWireTransmission(displayID);
-  Wire.write(IS31FL3730_Data_Registers);
+  // No displays until begin() is called
+  displayCount = 0;
+  presentDisplays = 0;
+  lastProbe = 0;
+  replayDisplays = 0;
+  replaying = false;
 
-  // Character array that stores the substring that is to be written
-  char substringValue[2];
+  // We have no idea what the displays are showing until we have written to
+  // them, so every register starts out dirty
+  memset(frameBuffer, 0x00, sizeof(frameBuffer));
+  for (int i = 0; i < GHOSTLAB42REBOOT_MAX_DISPLAYS; i++)
+  {
+    dirtyRegisters[i] = GHOSTLAB42REBOOT_ALL_REGISTERS_DIRTY;
+    powerAsserted[i] = false;
+    lastPowerAssert[i] = 0;
+  }
 
-  // Iterate over the print value and print out the individual characters
-  // Any string that goes over the number of digits gets cut off
-  // Any string that goes under the number of digits has blank spaces in
-  // in the remaining spots
-  for (int i = 0; i < value.length(); i++)
+  powerPolicy = POWER_ASSERT_ALWAYS;
+  powerInterval = 0;
+
+  setRetryPolicy(GHOSTLAB42REBOOT_RETRIES, GHOSTLAB42REBOOT_RETRY_BACKOFF);
+  memset(errorCounts, 0, sizeof(errorCounts));
+
+#if GHOSTLAB42REBOOT_STATS
+  memset(statistics, 0, sizeof(statistics));
+#endif
+
+#if GHOSTLAB42REBOOT_TRACE_LENGTH > 0
+  clearTrace();
+#endif
+
+#if GHOSTLAB42REBOOT_QUEUE_LENGTH > 0
+  asyncMode = false;
+  queueHead = 0;
+  queueCount = 0;
+  queueAttempts = 0;
+  queueBusHung = false;
+#endif
+
+  completionCallback = NULL;
+
+  frameOpen = false;
+
+  for (int i = 0; i < GHOSTLAB42REBOOT_MAX_DISPLAYS; i++)
   {
-    // Determine how the character should be written
-    // Handle decimal as first character
-    if (value.charAt(i) == '.' and (i == 0 || value.charAt(i - 1) == '.'))
+#if GHOSTLAB42REBOOT_SCROLL_LENGTH > 0
+    scrolls[i].active = false;
+#endif
+    fades[i].active = false;
+    updatePending[i] = false;
+
+    // The display driver starts out at full brightness, but we have not
+    // written the PWM Register yet
+    brightnessLevels[i] = 100;
+    pwmValues[i] = PWM_UNKNOWN;
+  }
+}
+
+/*
+ * Acts as the Constructor for the Reboot board set
+ *
+ * Would have liked to just use the constructor, but you can't call
+ * Wire.begin there :-/ (this is where the bus gets started)
+ *
+ * Parameters:
+ * powerPolicy   How often the maximum display power is re-asserted
+ * powerInterval Milliseconds between re-assertions for POWER_ASSERT_INTERVAL
+ *
+ * Returns the first error from setting up the displays, or
+ * GHOSTLAB42REBOOT_OK if every display is there
+ */
+byte GhostLab42Reboot::begin(GhostLab42RebootPowerPolicy powerPolicy,
+                             unsigned long powerInterval)
+{
+    return begin(rebootBoards, GHOSTLAB42REBOOT_DISPLAY_COUNT, powerPolicy, powerInterval);
+}
+
+/*
+ * Acts as the Constructor for any set of IS31FL3730 boards
+ *
+ * The display ID of each board is its index in boards. Boards past
+ * GHOSTLAB42REBOOT_MAX_DISPLAYS are ignored.
+ *
+ * Parameters:
+ * boards        The address, number of digits, and bus of every board. Does
+ *               not need to stick around
+ * boardCount    Number of boards in boards
+ * powerPolicy   How often the maximum display power is re-asserted
+ * powerInterval Milliseconds between re-assertions for POWER_ASSERT_INTERVAL
+ *
+ * Returns the first error from setting up the displays, or
+ * GHOSTLAB42REBOOT_OK if every display is there
+ */
+byte GhostLab42Reboot::begin(const GhostLab42RebootBoard boards[], byte boardCount,
+                             GhostLab42RebootPowerPolicy powerPolicy,
+                             unsigned long powerInterval)
+{
+    ApiHook hook;
+
+    displayCount = min(boardCount, (byte)GHOSTLAB42REBOOT_MAX_DISPLAYS);
+    for (int i = 0; i < displayCount; i++)
     {
-      substringValue[0] = ' ';
-      substringValue[1] = value.charAt(i);
+      // Boards without a bus of their own use the library's bus
+      // There is only room for so many digits in the data registers
+      this->boards[i] = boards[i];
+      if (this->boards[i].bus == NULL) this->boards[i].bus = bus;
+      this->boards[i].digits = min(boards[i].digits, (byte)GHOSTLAB42REBOOT_DATA_REGISTERS);
     }
-    // Handle decimal after a regular character
-    else if (value.charAt(i + 1) == '.')
-    {
-      // There is a decimal, write it as part of the character
-      // Prepare the substring
-      substringValue[0] = value.charAt(i);
-      substringValue[1] = value.charAt(i + 1);
 
-      // Skip the decimal
-      i++;
-    }
-    else
+    // Start every bus, but only once each
+    bus->begin();
+    for (int i = 0; i < displayCount; i++)
     {
-      // There isn't a decimal, write the character normally
-      // Prepare the substring
-      substringValue[0] = value.charAt(i);
+      bool started = (this->boards[i].bus == bus);
+      for (int j = 0; j < i && started == false; j++)
+      {
+        started = (this->boards[j].bus == this->boards[i].bus);
+      }
+      if (started == false) this->boards[i].bus->begin();
     }
 
-    // Write the substring
-    writeCharacter(substringValue);
-
-    // Clear out the substring array
-    memset(&substringValue[0], 0, sizeof(substringValue));
-  }
+    this->powerPolicy = powerPolicy;
+    this->powerInterval = powerInterval;
 
-  // End the temporary register transmission
-  Wire.endTransmission();
+    // Find out which boards are actually plugged in, the rest get skipped
+    // until they are found again
+    presentDisplays = 0;
+    for (int i = 0; i < displayCount; i++)
+    {
+      if (probeDisplay(i)) bitSet(presentDisplays, i);
+    }
+    lastProbe = millis();
 
-  // Set the current again, in case a wire was unplugged sometime between
-  // the last current reset and now
-  setDisplayPowerMax(displayID);
+    // Set the maximum display power for all of the displays
+    byte status = GHOSTLAB42REBOOT_OK;
+    for (int i = 0; i < displayCount; i++)
+    {
+      byte displayStatus = setDisplayPowerMax(i);
+      if (status == GHOSTLAB42REBOOT_OK) status = displayStatus;
+    }
+    return status;
+}
 
-  // Transfer the display data from the temporary registers to the display
-  setupWireTransmission(displayID);
+/******************************************************************************
+ *                              Public Functions                              *
+ ******************************************************************************/
 
-  // Write to the Update Column Register to let the board know we want to
-  // update the display
-  Wire.write(IS31FL3730_Update_Column_Register);
+/*
+ * Number of displays that were set up by begin()
+ */
+int GhostLab42Reboot::getDisplayCount()
+{
+  return displayCount;
+}
 
-  // Send any value to initate the display (value ignored)
-  Wire.write(0x00);
+/*
+ * Number of digits on the selected display, or 0 if there is no such display
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+int GhostLab42Reboot::getDisplayDigits(int displayID)
+{
+  if (verifyDisplayID(displayID) == false) return 0;
 
-  // End the Updte Column Register Transmission
-  Wire.endTransmission();
+  return boards[displayID].digits;
 }
 
 /*
- * Resets the display and sets the current to the maximum allowed
+ * Whether the selected display answered the last time the library talked to
+ * it
  *
  * Parameters:
  * displayID Unique identifier for the display
  */
-void GhostLab42Reboot::resetDisplay(int displayID)
+bool GhostLab42Reboot::isPresent(int displayID)
 {
-  // Verify the display exists before attempting to reset it
-  if (verifyDisplayID(displayID) == false) return;
+  if (verifyDisplayID(displayID) == false) return false;
 
-  // Make sure the maximum current for the display is not exceeded
-  setDisplayPowerMax(displayID);
-
-  setupWireTransmission(displayID);
+  return bitRead(presentDisplays, displayID);
+}
 
-  // Reset the display so that the display is blank
-  // Send any value to reset the display (value ignored)
-  Wire.write(IS31FL3730_Reset_Register);
-  Wire.write(0x00);
-  Wire.endTransmission();
+/*
+ * Writes the characters to the selected display. The only characters allowed
+ * are numbers 0-9 and letters A, b, C, d, E, and F
+ *
+ * All of the write() overloads return GHOSTLAB42REBOOT_OK or the first
+ * error from sending the characters to the display
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * value     The characters to write
+ */
+byte GhostLab42Reboot::write(int displayID, const String &value)
+{
+  ApiHook hook;
 
-  // Reset the current again, just to be careful since the display
-  // was just reset
-  setDisplayPowerMax(displayID);
+  return writeText(displayID, value.c_str(), value.length(), false);
 }
 
-/**
- * Set the brightness level of the display
+/*
+ * Writes a null-terminated string to the selected display without touching
+ * the heap
  *
  * Parameters:
- * displayID  Unique identifier for the display
- * brightness The dimming level percentage as an int 0 - 100.
+ * displayID Unique identifier for the display
+ * value     The characters to write
  */
-void GhostLab42Reboot::setDisplayBrightness (int displayID, int brightness)
+byte GhostLab42Reboot::write(int displayID, const char *value)
 {
-  // Verify the display exists before attempting to set its brightness
-  if (verifyDisplayID(displayID) == false) return;
+  ApiHook hook;
 
-  // Make sure the maximum current for the display is not exceeded
-  setDisplayPowerMax(displayID);
+  return writeText(displayID, value, strlen(value), false);
+}
 
-  // Begin dimming the display
-  setupWireTransmission(displayID);
+/*
+ * Writes a fixed number of characters to the selected display
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * value     The characters to write, does not need to be null-terminated
+ * length    Number of characters in value
+ */
+byte GhostLab42Reboot::write(int displayID, const char *value, size_t length)
+{
+  ApiHook hook;
 
-  // Tell the lighting effect register to display at the desired
-  // brightness level with values from the light correction lookup table
-  Wire.write(IS31FL3730_PWM_Register);
-  Wire.write(lightCorrectionTable[brightness]);
-  Wire.endTransmission();
+  return writeText(displayID, value, length, false);
 }
 
-/******************************************************************************
- *                             Private Functions                              *
- ******************************************************************************/
+/*
+ * Writes a buffer of characters to the selected display
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * value     The characters to write, does not need to be null-terminated
+ * length    Number of characters in value
+ */
+byte GhostLab42Reboot::write(int displayID, const uint8_t *value, size_t length)
+{
+  ApiHook hook;
+
+  return writeText(displayID, reinterpret_cast<const char *>(value), length, false);
+}
 
 /*
- * Makes sure the user passes the library a valid display ID
+ * Writes a flash string (ex. F("HELLO")) to the selected display, reading it
+ * straight out of flash
  *
  * Parameters:
  * displayID Unique identifier for the display
+ * value     The characters to write
  */
-bool GhostLab42Reboot::verifyDisplayID(int displayID)
+byte GhostLab42Reboot::write(int displayID, const __FlashStringHelper *value)
 {
-  // User can technically give us any ID
-  // If they give us a bad ID, return false
-  return (displayID != 0 || displayID != 1 || displayID != 2);
+  ApiHook hook;
+
+  PGM_P text = reinterpret_cast<PGM_P>(value);
+  return writeText(displayID, text, strlen_P(text), true);
 }
 
 /*
- * Sets the current to the minimum (5mA per segment)
- * Not currently in use by the library, but it is good to keep it around
- * as an option for more advanced users
+ * Writes a number to the selected display without building a String
+ *
+ * The number can be a fixed-point value, in which case the decimal point is
+ * placed in front of the last "decimals" digits (ex. 1262 with 1 decimal is
+ * shown as 126.2). The whole display is written, so there is no need to
+ * reset it first. If the number does not fit, dashes are shown instead.
  *
  * Parameters:
  * displayID Unique identifier for the display
+ * value     The number to write
+ * decimals  Number of digits after the decimal point
+ * padding   Character used to fill the unused digits in front of a right
+ *           aligned number, ex. '0' for leading zeros
+ * align     Whether the number sits against the left or right of the display
+ *
+ * Returns GHOSTLAB42REBOOT_ERROR_OVERFLOW if the number did not fit on the
+ * display, otherwise the result of sending it
  */
-void GhostLab42Reboot::setDisplayPowerMin(int displayID)
+byte GhostLab42Reboot::writeNumber(int displayID, int32_t value, byte decimals,
+                                   char padding, GhostLab42RebootAlign align)
 {
-  setupWireTransmission(displayID);
+  ApiHook hook;
 
-  Wire.write(IS31FL3730_Lighting_Effect_Register);
-  Wire.write(0x08); // Lowest level, 10mA
-  Wire.endTransmission();
+  // Verify the display exists before attempting to write to it
+  if (verifyDisplayID(displayID) == false) return GHOSTLAB42REBOOT_ERROR_INVALID_DISPLAY;
+
+#if GHOSTLAB42REBOOT_STATS
+  LatencyTimer timer(statistics[displayID]);
+#endif
+
+  bool negative = (value < 0);
+  uint32_t magnitude = negative ? -(uint32_t)value : value;
+  return writeDigits(displayID, negative, magnitude, decimals, padding, align);
 }
 
 /*
- * Sets the current to the maximum allowed for these displays (0mA per segment)
+ * Writes a fixed-point number to the selected display, dropping decimals
+ * until it fits
+ *
+ * Works like writeNumber(), except that decimals that do not fit on the
+ * display are rounded off (ex. 126.25 with 2 decimals is shown as 126.3 on
+ * a four-digit display). Dashes are only shown if the number does not fit
+ * with no decimals at all.
  *
  * Parameters:
  * displayID Unique identifier for the display
+ * mantissa  The number to write, with the decimal point taken out
+ * decimals  Number of digits of the mantissa after the decimal point
+ * padding   Character used to fill the unused digits in front of a right
+ *           aligned number, ex. '0' for leading zeros
+ * align     Whether the number sits against the left or right of the display
+ *
+ * Returns GHOSTLAB42REBOOT_ERROR_OVERFLOW if the number did not fit on the
+ * display, otherwise the result of sending it
  */
-void GhostLab42Reboot::setDisplayPowerMax(int displayID)
+byte GhostLab42Reboot::writeFixed(int displayID, long mantissa, byte decimals,
+                                  char padding, GhostLab42RebootAlign align)
 {
-  // The display driver allows currents greater than the displays should
-  // take - do not allow anything over 20mA!
-  // The display driver resets to 40mA per segment which is too much. This
-  // should be called before every function that writes to the display to
-  // ensure that the current is not exceeded in the case that a wire is
-  // accidentally disconnected
+  ApiHook hook;
+
+  // Verify the display exists before attempting to write to it
+  if (verifyDisplayID(displayID) == false) return GHOSTLAB42REBOOT_ERROR_INVALID_DISPLAY;
+
+#if GHOSTLAB42REBOOT_STATS
+  LatencyTimer timer(statistics[displayID]);
+#endif
+
+  bool negative = (mantissa < 0);
+  uint32_t magnitude = negative ? -(unsigned long)mantissa : mantissa;
+
+  // Drop decimals until the number fits, rounding half away from zero
+  // Every try is rounded from the original mantissa, since rounding off one
+  // decimal at a time rounds twice (123.449 would become 123.45, then 123.5)
+  byte width = boards[displayID].digits;
+  uint32_t rounded = magnitude;
+  uint32_t divisor = 1;
+  while (decimals > 0 && countNumberDigits(negative && rounded > 0, rounded, decimals) > width)
+  {
+    decimals--;
+    if (divisor <= 100000000UL)
+    {
+      divisor *= 10;
+      rounded = magnitude / divisor + ((magnitude % divisor >= divisor / 2) ? 1 : 0);
+    }
+    else
+    {
+      // Dropping 10 or more digits leaves nothing of a long to round up
+      rounded = 0;
+    }
+  }
 
-  setupWireTransmission(displayID);
+  // Rounding can leave nothing behind the minus sign
+  if (rounded == 0) negative = false;
 
-  Wire.write(IS31FL3730_Lighting_Effect_Register);
-  Wire.write(0x0B); // Highest level, 20mA
-  Wire.endTransmission();
+  return writeDigits(displayID, negative, rounded, decimals, padding, align);
 }
 
 /*
- * Set up the Wire transmission depending on the display being used
+ * Writes a decimal number to the selected display without dtostrf() or
+ * String, dropping decimals until it fits
+ *
+ * The number is scaled and rounded to a whole number once, and everything
+ * after that is done the same way as writeNumber(). Keep in mind that a
+ * float only holds about 7 significant digits on AVR.
  *
  * Parameters:
  * displayID Unique identifier for the display
+ * value     The number to write
+ * decimals  Most digits to show after the decimal point
+ * padding   Character used to fill the unused digits in front of a right
+ *           aligned number, ex. '0' for leading zeros
+ * align     Whether the number sits against the left or right of the display
+ *
+ * Returns GHOSTLAB42REBOOT_ERROR_OVERFLOW if the number did not fit on the
+ * display (or is not a number), otherwise the result of sending it
  */
-void GhostLab42Reboot::setupWireTransmission(int displayID)
+byte GhostLab42Reboot::writeFixed(int displayID, double value, byte decimals,
+                                  char padding, GhostLab42RebootAlign align)
 {
-  if (displayID == 0)
+  ApiHook hook;
+
+  // Verify the display exists before attempting to write to it
+  if (verifyDisplayID(displayID) == false) return GHOSTLAB42REBOOT_ERROR_INVALID_DISPLAY;
+
+#if GHOSTLAB42REBOOT_STATS
+  LatencyTimer timer(statistics[displayID]);
+#endif
+
+  bool negative = (value < 0);
+  if (negative) value = -value;
+
+  // There is never room for more decimals than the display has digits
+  byte width = boards[displayID].digits;
+  if (decimals >= width) decimals = width - 1;
+
+  // Scale from the original value every time so the number is only ever
+  // rounded once
+  uint32_t magnitude;
+  while (true)
   {
-    // Use the six digit display
-    Wire.beginTransmission(IS31FL3730_DIGIT_6_I2C_ADDRESS);
+    double scale = 1;
+    for (byte i = 0; i < decimals; i++) scale *= 10;
+    double scaled = value * scale + 0.5;
+
+    // Also catches NaN and infinity
+    if (!(scaled < 4294967296.0))
+    {
+      if (decimals == 0) return writeOverflow(displayID);
+      decimals--;
+      continue;
+    }
+
+    // Rounding can leave nothing behind the minus sign, which then makes
+    // room for another decimal
+    magnitude = (uint32_t)scaled;
+    if (decimals == 0 || countNumberDigits(negative && magnitude > 0, magnitude, decimals) <= width) break;
+    decimals--;
   }
-  else if (displayID == 1)
+
+  if (magnitude == 0) negative = false;
+
+  return writeDigits(displayID, negative, magnitude, decimals, padding, align);
+}
+
+/*
+ * Writes raw segments to the selected display, leaving the digits around
+ * them alone
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * segments  The segments to light for each digit (gfedcba format, with the
+ *           decimal point as the highest bit)
+ * count     Number of digits in segments
+ * offset    The digit to start at, 0 being the leftmost
+ *
+ * Returns the result of sending the digits that changed
+ */
+byte GhostLab42Reboot::writeSegments(int displayID, const byte segments[], byte count, byte offset)
+{
+  ApiHook hook;
+
+  // Verify the display exists before attempting to write to it
+  if (verifyDisplayID(displayID) == false) return GHOSTLAB42REBOOT_ERROR_INVALID_DISPLAY;
+
+#if GHOSTLAB42REBOOT_STATS
+  LatencyTimer timer(statistics[displayID]);
+#endif
+
+  // Anything past the end of the display gets cut off
+  byte frame[GHOSTLAB42REBOOT_DATA_REGISTERS];
+  memcpy(frame, frameBuffer[displayID], sizeof(frame));
+  byte width = boards[displayID].digits;
+  for (byte i = 0; i < count && offset + i < width; i++)
   {
-    // Use the smaller four digit display
-    Wire.beginTransmission(IS31FL3730_DIGIT_4S_I2C_ADDRESS);
+    frame[offset + i] = segments[i];
   }
-  else if (displayID == 2)
+
+  // Only send the registers that actually changed
+  return commitFrame(displayID, frame);
+}
+
+/*
+ * Number of digits a number takes up on a display, including the minus sign
+ * and the digit in front of the decimal point
+ *
+ * Parameters:
+ * negative  Whether the number has a minus sign
+ * magnitude The number without its sign or decimal point
+ * decimals  Number of digits after the decimal point
+ */
+byte GhostLab42Reboot::countNumberDigits(bool negative, uint32_t magnitude, byte decimals)
+{
+  byte digitCount = 0;
+  do
   {
-    // Use the four digit display
-    Wire.beginTransmission(IS31FL3730_DIGIT_4_I2C_ADDRESS);
+    digitCount++;
+    magnitude /= 10;
   }
+  while (magnitude > 0);
+
+  if (digitCount <= decimals) digitCount = decimals + 1;
+  return digitCount + (negative ? 1 : 0);
 }
 
 /*
- * Converts characters into the appropriate bytes for display (gfedcba format)
+ * Lays a number out on the selected display, for writeNumber() and
+ * writeFixed()
  *
  * Parameters:
- * displayCharacters The character(s) to be converted into a byte for the
- *                   display. Some characters like "W" need multiple digits.
+ * displayID Unique identifier for the display
+ * negative  Whether the number has a minus sign
+ * magnitude The number without its sign or decimal point
+ * decimals  Number of digits of the magnitude after the decimal point
+ * padding   Character used to fill the unused digits in front of a right
+ *           aligned number
+ * align     Whether the number sits against the left or right of the display
  */
-void GhostLab42Reboot::writeCharacter(char displayCharacters[])
+byte GhostLab42Reboot::writeDigits(int displayID, bool negative, uint32_t magnitude,
+                                   byte decimals, char padding, GhostLab42RebootAlign align)
 {
-  // Although this isn't very time efficient (linear time) it's apparently a
-  // very bad idea to use hashmaps on Arduino because they're resource
-  // intensive :-(
+  byte width = boards[displayID].digits;
 
-  // Sometimes decimals are involved, so we need something to add it
-  byte decimalOffset = 0x00; // No decimal to add
-  if (displayCharacters[1] == '.')
+  // Build the new frame on top of what the display is already showing
+  // Only the digits of the display get overwritten
+  byte frame[GHOSTLAB42REBOOT_DATA_REGISTERS];
+  memcpy(frame, frameBuffer[displayID], sizeof(frame));
+
+  // Pull the digits off from right to left
+  // Always show at least one digit in front of the decimal point
+  byte digits[GHOSTLAB42REBOOT_DATA_REGISTERS];
+  byte digitCount = 0;
+  do
   {
-    // Add a decimal
-    decimalOffset = 0x80;
+    digits[digitCount++] = magnitude % 10;
+    magnitude /= 10;
+  }
+  while ((magnitude > 0 || digitCount <= decimals) &&
+         digitCount < GHOSTLAB42REBOOT_DATA_REGISTERS);
+
+  byte numberWidth = digitCount + (negative ? 1 : 0);
+  if (magnitude > 0 || decimals >= width || numberWidth > width)
+  {
+    return writeOverflow(displayID);
+  }
+
+  // Work out where the number starts and what goes in front of it
+  byte paddingSegments = 0x00;
+  if (align == ALIGN_RIGHT)
+  {
+    byte paddingGlyphs[2];
+    char paddingCharacters[2] = {padding, 0};
+    encodeCharacter(paddingCharacters, paddingGlyphs);
+    paddingSegments = paddingGlyphs[0];
+  }
+  byte start = (align == ALIGN_RIGHT) ? width - numberWidth : 0;
+  memset(frame, 0x00, width);
+  memset(frame, paddingSegments, start);
+
+  // Leading zeros go between the minus sign and the number
+  if (negative)
+  {
+    if (align == ALIGN_RIGHT && padding == '0')
+    {
+      frame[start] = paddingSegments;
+      frame[0] = minusSegments;
+    }
+    else
+    {
+      frame[start] = minusSegments;
+    }
   }
+  byte position = start + (negative ? 1 : 0);
+
+  // Lay the digits down from left to right, with the decimal point folded
+  // into the last digit in front of the decimals
+  for (byte i = digitCount; i > 0; i--)
+  {
+    frame[position] = pgm_read_word(&glyphTable['0' + digits[i - 1]]);
+    if (decimals > 0 && i - 1 == decimals) frame[position] |= decimalSegment;
+    position++;
+  }
+
+  // Only send the registers that actually changed
+  return commitFrame(displayID, frame);
+}
+
+/*
+ * Fills the selected display with dashes, for a number that does not fit
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ *
+ * Returns GHOSTLAB42REBOOT_ERROR_OVERFLOW if the dashes were sent, otherwise
+ * the result of sending them
+ */
+byte GhostLab42Reboot::writeOverflow(int displayID)
+{
+  byte frame[GHOSTLAB42REBOOT_DATA_REGISTERS];
+  memcpy(frame, frameBuffer[displayID], sizeof(frame));
+  memset(frame, minusSegments, boards[displayID].digits);
+  byte status = commitFrame(displayID, frame);
+  return (status == GHOSTLAB42REBOOT_OK) ? GHOSTLAB42REBOOT_ERROR_OVERFLOW : status;
+}
+
+/*
+ * Resets the display and sets the current to the maximum allowed
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ *
+ * Returns GHOSTLAB42REBOOT_OK or the first error, the rest of the reset is
+ * skipped after an error
+ */
+byte GhostLab42Reboot::resetDisplay(int displayID)
+{
+  ApiHook hook;
+
+  // Verify the display exists before attempting to reset it
+  if (verifyDisplayID(displayID) == false) return GHOSTLAB42REBOOT_ERROR_INVALID_DISPLAY;
+
+#if GHOSTLAB42REBOOT_STATS
+  LatencyTimer timer(statistics[displayID]);
+#endif
+
+  // A missing display gets the blank shadow copy once it is found again, and
+  // that could be on the way to this reset, so blank it first rather than
+  // bringing back what it showed before
+  if (bitRead(presentDisplays, displayID) == 0) clearShadow(displayID);
+
+  // Make sure the maximum current for the display is not exceeded
+  byte status = assertDisplayPower(displayID);
+
+  // Reset the display so that the display is blank
+  // Send any value to reset the display (value ignored)
+  if (status == GHOSTLAB42REBOOT_OK)
+  {
+    status = writeRegister(displayID, IS31FL3730_Reset_Register, 0x00);
+  }
+
+  // If the reset did not go through, the display still shows what the shadow
+  // copy says it does. A missing display gets the blank shadow copy once it
+  // is found again, so that counts as reset
+  if (status != GHOSTLAB42REBOOT_OK && status != GHOSTLAB42REBOOT_ERROR_NOT_PRESENT) return status;
+
+  // The display is blank after the reset, so the shadow copy is too
+  clearShadow(displayID);
+
+  if (status != GHOSTLAB42REBOOT_OK) return status;
+
+  // The reset puts the current back to the 40mA default, so this one is
+  // required no matter what the power policy is
+  return setDisplayPowerMax(displayID);
+}
+
+/**
+ * Set the brightness level of the display
+ *
+ * Stops any fade that is running on the display, so it does not write over
+ * the new level on the next update()
+ *
+ * Parameters:
+ * displayID  Unique identifier for the display
+ * brightness The dimming level percentage as an int 0 - 100.
+ */
+byte GhostLab42Reboot::setDisplayBrightness (int displayID, int brightness)
+{
+  ApiHook hook;
+
+  // Verify the display exists before attempting to set its brightness
+  if (verifyDisplayID(displayID) == false) return GHOSTLAB42REBOOT_ERROR_INVALID_DISPLAY;
+
+#if GHOSTLAB42REBOOT_STATS
+  LatencyTimer timer(statistics[displayID]);
+#endif
+
+  fades[displayID].active = false;
+  return writeBrightness(displayID, brightness, false);
+}
+
+/*
+ * Starts a frame. Until endFrame() is called, anything written to the
+ * displays only goes into their temporary registers and does not show up
+ *
+ * This loads the data for every display first so that endFrame() can update
+ * all of them at once, instead of each display changing a few milliseconds
+ * after the one before it
+ */
+void GhostLab42Reboot::beginFrame()
+{
+  ApiHook hook;
+
+  frameOpen = true;
+}
+
+/*
+ * Ends a frame, updating every display that was written to since
+ * beginFrame() back-to-back so they all change at the same time
+ *
+ * Returns the first error from updating the displays, the rest are still
+ * updated
+ */
+byte GhostLab42Reboot::endFrame()
+{
+  ApiHook hook;
+
+  frameOpen = false;
+
+  byte status = GHOSTLAB42REBOOT_OK;
+
+  // Nothing but the Update Column Register writes go out in here, so the
+  // displays update within a few bytes on the bus of each other
+  for (int i = 0; i < displayCount; i++)
+  {
+    if (updatePending[i])
+    {
+      updatePending[i] = false;
+
+      // Send any value to initate the display (value ignored)
+      byte displayStatus = writeRegister(i, IS31FL3730_Update_Column_Register, 0x00);
+      if (status == GHOSTLAB42REBOOT_OK) status = displayStatus;
+    }
+  }
+
+  return status;
+}
+
+/*
+ * Fades the brightness of the selected display to a new level over time
+ *
+ * The fade moves in steps of perceived brightness (the same percentages that
+ * setDisplayBrightness uses), and update() has to be called from loop() to
+ * keep it going. The display is only written to when the fade reaches a
+ * level that actually looks different. Starting a new fade on a display
+ * replaces the one that was already running.
+ *
+ * Parameters:
+ * displayID  Unique identifier for the display
+ * brightness The dimming level percentage to end up at as an int 0 - 100
+ * duration   Milliseconds the fade should take
+ * easing     How the fade speeds up and slows down along the way
+ */
+byte GhostLab42Reboot::fadeTo(int displayID, int brightness, unsigned long duration,
+                              GhostLab42RebootEasing easing)
+{
+  ApiHook hook;
+
+  // Verify the display exists before attempting to fade it
+  if (verifyDisplayID(displayID) == false) return GHOSTLAB42REBOOT_ERROR_INVALID_DISPLAY;
+
+  Fade &fade = fades[displayID];
+  fade.startBrightness = brightnessLevels[displayID];
+  fade.targetBrightness = constrain(brightness, 0, 100);
+  fade.startTime = millis();
+  fade.duration = duration;
+  fade.easing = easing;
+  fade.active = true;
+
+  // Take the first step right away, which also finishes a fade with no
+  // duration
+  return stepFade(displayID);
+}
+
+/*
+ * Whether the brightness of the selected display is currently fading
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+bool GhostLab42Reboot::isFading(int displayID)
+{
+  if (verifyDisplayID(displayID) == false) return false;
+
+  return fades[displayID].active;
+}
+
+#if GHOSTLAB42REBOOT_SCROLL_LENGTH > 0
+/*
+ * Scrolls text across the selected display, one digit per step
+ *
+ * The text is encoded once up front (decimals are wrapped into the previous
+ * character's digit like they are for write()), and every step just slides a
+ * window across the encoded digits, so update() has to be called from loop()
+ * to keep the text moving. The scroll starts over once the text has moved
+ * all the way across, and keeps going until stopScroll() is called. Text that
+ * encodes to more than GHOSTLAB42REBOOT_SCROLL_LENGTH digits gets cut off.
+ * Returns the result of showing the first step.
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * text      The characters to scroll, does not need to stick around
+ * msPerStep Milliseconds between each step
+ */
+byte GhostLab42Reboot::scroll(int displayID, const char *text, unsigned long msPerStep)
+{
+  ApiHook hook;
+
+  return startScroll(displayID, text, strlen(text), false, msPerStep);
+}
+
+/*
+ * Scrolls a flash string (ex. F("HELLO")) across the selected display, one
+ * digit per step
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * text      The characters to scroll
+ * msPerStep Milliseconds between each step
+ */
+byte GhostLab42Reboot::scroll(int displayID, const __FlashStringHelper *text,
+                              unsigned long msPerStep)
+{
+  ApiHook hook;
+
+  PGM_P flashText = reinterpret_cast<PGM_P>(text);
+  return startScroll(displayID, flashText, strlen_P(flashText), true, msPerStep);
+}
+
+/*
+ * Stops scrolling text across the selected display. Whatever is on the
+ * display stays there
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+byte GhostLab42Reboot::stopScroll(int displayID)
+{
+  ApiHook hook;
+
+  if (verifyDisplayID(displayID) == false) return GHOSTLAB42REBOOT_ERROR_INVALID_DISPLAY;
+
+  scrolls[displayID].active = false;
+  return GHOSTLAB42REBOOT_OK;
+}
+
+/*
+ * Whether text is currently scrolling across the selected display
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+bool GhostLab42Reboot::isScrolling(int displayID)
+{
+  if (verifyDisplayID(displayID) == false) return false;
+
+  return scrolls[displayID].active;
+}
+#endif
+
+#if GHOSTLAB42REBOOT_QUEUE_LENGTH > 0
+/*
+ * Turns async mode on or off
+ *
+ * In async mode the library does not wait for anything to go out on the bus.
+ * Every transaction is fully encoded and put in a queue instead, and update()
+ * sends them one at a time so that loop() is never held up for more than a
+ * single transaction. A failed transaction is tried again by a later update()
+ * once its backoff is over rather than waiting for it. If the queue fills
+ * up, the oldest transaction is sent right away to make room. Turning async
+ * mode off sends everything that is still waiting.
+ *
+ * While async mode is on, the functions that write to the displays return
+ * GHOSTLAB42REBOOT_OK once the transactions are queued. The result of each
+ * transaction goes to the completion callback instead.
+ *
+ * Parameters:
+ * enabled Whether async mode should be on
+ *
+ * Returns the first error from sending what was still waiting
+ */
+byte GhostLab42Reboot::setAsyncMode(bool enabled)
+{
+  ApiHook hook;
+
+  byte status = GHOSTLAB42REBOOT_OK;
+  if (enabled == false) status = sendQueue();
+  asyncMode = enabled;
+  return status;
+}
+#endif
+
+/*
+ * Sets the function that gets called whenever a transaction to a display
+ * finishes, successful or not
+ *
+ * Parameters:
+ * callback The function to call, or NULL to stop calling it
+ */
+void GhostLab42Reboot::setCompletionCallback(GhostLab42RebootCallback callback)
+{
+  completionCallback = callback;
+}
+
+/*
+ * Sets how many times a failed transaction is tried again before giving up
+ *
+ * The wait before each retry doubles, so the longest a single transaction can
+ * spend waiting is backoff * (2^retries - 1) microseconds. A transaction that
+ * was too long for the bus is never retried.
+ *
+ * Parameters:
+ * retries Number of times to try again after the first attempt, up to
+ *         GHOSTLAB42REBOOT_MAX_RETRIES
+ * backoff Microseconds to wait before the first retry
+ */
+void GhostLab42Reboot::setRetryPolicy(byte retries, unsigned int backoff)
+{
+  this->retries = min(retries, (byte)GHOSTLAB42REBOOT_MAX_RETRIES);
+  retryBackoff = backoff;
+}
+
+/*
+ * Number of failed attempts to talk to the selected display since begin()
+ * or the last clearErrorCounts(), counting every retry
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+GhostLab42RebootErrorCounts GhostLab42Reboot::getErrorCounts(int displayID)
+{
+  if (verifyDisplayID(displayID) == false)
+  {
+    GhostLab42RebootErrorCounts none = {0, 0, 0};
+    return none;
+  }
+
+  return errorCounts[displayID];
+}
+
+/*
+ * Resets the error counts of the selected display
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+byte GhostLab42Reboot::clearErrorCounts(int displayID)
+{
+  if (verifyDisplayID(displayID) == false) return GHOSTLAB42REBOOT_ERROR_INVALID_DISPLAY;
+
+  memset(&errorCounts[displayID], 0, sizeof(errorCounts[displayID]));
+  return GHOSTLAB42REBOOT_OK;
+}
+
+#if GHOSTLAB42REBOOT_STATS
+/*
+ * What the library has sent to the selected display since begin() or the
+ * last clearStats(). Only there when GHOSTLAB42REBOOT_STATS is turned on
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+const GhostLab42RebootStats &GhostLab42Reboot::stats(int displayID)
+{
+  static const GhostLab42RebootStats none = {};
+  if (verifyDisplayID(displayID) == false) return none;
+
+  return statistics[displayID];
+}
+
+/*
+ * Resets the stats of the selected display
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+byte GhostLab42Reboot::clearStats(int displayID)
+{
+  if (verifyDisplayID(displayID) == false) return GHOSTLAB42REBOOT_ERROR_INVALID_DISPLAY;
+
+  memset(&statistics[displayID], 0, sizeof(statistics[displayID]));
+  return GHOSTLAB42REBOOT_OK;
+}
+#endif
+
+#if GHOSTLAB42REBOOT_TRACE_LENGTH > 0
+/*
+ * Writes every transaction in the trace, oldest first, in the binary format
+ * described in documentation/developer/trace.md. Only there when
+ * GHOSTLAB42REBOOT_TRACE_LENGTH is more than 0
+ *
+ * Parameters:
+ * out Where to write the trace, ex. Serial
+ *
+ * Returns the number of bytes written
+ */
+size_t GhostLab42Reboot::dumpTrace(Print &out)
+{
+  // Header
+  size_t written = out.write((const uint8_t *)"GLTR", 4);
+  written += out.write((byte)GHOSTLAB42REBOOT_TRACE_VERSION);
+  written += out.write((byte)GHOSTLAB42REBOOT_TRACE_RECORD_SIZE);
+  written += out.write(lowByte(traceCount));
+  written += out.write(highByte(traceCount));
+  written += writeTraceLong(out, traceDropped);
+
+  // Records
+  for (uint16_t i = 0; i < traceCount; i++)
+  {
+    const TraceRecord &record = trace[(traceHead + i) % GHOSTLAB42REBOOT_TRACE_LENGTH];
+    written += writeTraceLong(out, record.timestamp);
+    written += out.write(record.address);
+    written += out.write(record.firstRegister);
+    written += out.write(record.length);
+    written += out.write(record.status);
+  }
+
+  return written;
+}
+
+/*
+ * Forgets every transaction in the trace
+ */
+void GhostLab42Reboot::clearTrace()
+{
+  traceHead = 0;
+  traceCount = 0;
+  traceDropped = 0;
+}
+#endif
+
+/*
+ * Print sink for the selected display, so anything Print can format (ex.
+ * reboot.on(0).println(3.14159, 2)) goes straight into the display encoder
+ * without building a String
+ *
+ * Everything printed shows up once a line is finished or the sink is
+ * flushed, and replaces the whole display. Selecting a different display
+ * finishes what was printed to the last one.
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+GhostLab42RebootPrint &GhostLab42Reboot::on(int displayID)
+{
+  if (printSink.displayID != displayID)
+  {
+    printSink.commit();
+    printSink.displayID = displayID;
+  }
+
+  return printSink;
+}
+
+/*
+ * Lets the library do its background work. Call this from loop() as often as
+ * possible
+ *
+ * Moves any scrolling text and brightness fades along, checks whether any
+ * missing displays have been plugged back in, finishes bringing back the
+ * displays on a bus that hung, and sends the next queued transaction in
+ * async mode
+ *
+ * Returns the first error from anything that was sent
+ */
+byte GhostLab42Reboot::update()
+{
+  ApiHook hook;
+
+#if GHOSTLAB42REBOOT_SCROLL_LENGTH > 0
+  unsigned long now = millis();
+#endif
+  byte status = GHOSTLAB42REBOOT_OK;
+  byte stepStatus;
+
+  // Every so often, look for displays that have gone missing and bring back
+  // whatever they should be showing
+  probeMissingDisplays();
+
+  // Finish bringing back the displays on a bus that hung
+  if (replayDisplays != 0) replayPendingDisplays();
+
+  for (int i = 0; i < displayCount; i++)
+  {
+#if GHOSTLAB42REBOOT_SCROLL_LENGTH > 0
+    if (scrolls[i].active && (long)(now - scrolls[i].nextStep) >= 0)
+    {
+      stepStatus = stepScroll(i);
+      if (status == GHOSTLAB42REBOOT_OK) status = stepStatus;
+    }
+#endif
+
+    if (fades[i].active)
+    {
+      stepStatus = stepFade(i);
+      if (status == GHOSTLAB42REBOOT_OK) status = stepStatus;
+    }
+  }
+
+#if GHOSTLAB42REBOOT_QUEUE_LENGTH > 0
+  if (queueCount > 0)
+  {
+    stepStatus = sendNextTransaction(false);
+    if (status == GHOSTLAB42REBOOT_OK) status = stepStatus;
+  }
+#endif
+
+  return status;
+}
+
+/*
+ * Waits until every queued transaction has gone out on the bus
+ *
+ * Returns the first error from the transactions that were sent
+ */
+byte GhostLab42Reboot::flush()
+{
+#if GHOSTLAB42REBOOT_QUEUE_LENGTH > 0
+  ApiHook hook;
+
+  return sendQueue();
+#else
+  return GHOSTLAB42REBOOT_OK;
+#endif
+}
+
+/*
+ * Whether there is nothing left waiting to go out on the bus
+ */
+bool GhostLab42Reboot::isIdle()
+{
+#if GHOSTLAB42REBOOT_QUEUE_LENGTH > 0
+  return (queueCount == 0);
+#else
+  return true;
+#endif
+}
+
+/******************************************************************************
+ *                             Private Functions                              *
+ ******************************************************************************/
+
+/*
+ * Makes sure the user passes the library a valid display ID
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+bool GhostLab42Reboot::verifyDisplayID(int displayID)
+{
+  // User can technically give us any ID
+  // If they give us a bad ID, return false
+  // The display ID also indexes the shadow frame buffers, so this has to be
+  // strict
+  return (displayID >= 0 && displayID < displayCount);
+}
+
+/*
+ * Sets the current to the minimum (5mA per segment)
+ * Not currently in use by the library, but it is good to keep it around
+ * as an option for more advanced users
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+byte GhostLab42Reboot::setDisplayPowerMin(int displayID)
+{
+  return writeRegister(displayID, IS31FL3730_Lighting_Effect_Register, 0x08); // Lowest level, 10mA
+}
+
+/*
+ * Sets the current to the maximum allowed for these displays (0mA per segment)
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+byte GhostLab42Reboot::setDisplayPowerMax(int displayID)
+{
+  // The display driver allows currents greater than the displays should
+  // take - do not allow anything over 20mA!
+  // The display driver resets to 40mA per segment which is too much. This
+  // should be called before every function that writes to the display to
+  // ensure that the current is not exceeded in the case that a wire is
+  // accidentally disconnected
+
+  // Only trust the current setting as long as the display actually
+  // receives it (see finishTransaction)
+  powerAsserted[displayID] = true;
+  lastPowerAssert[displayID] = millis();
+
+#if GHOSTLAB42REBOOT_STATS
+  statistics[displayID].powerAsserts++;
+#endif
+
+  return writeRegister(displayID, IS31FL3730_Lighting_Effect_Register, 0x0B); // Highest level, 20mA
+}
+
+/*
+ * Re-asserts the maximum display power if the power policy calls for it
+ *
+ * POWER_ASSERT_ALWAYS re-asserts before every operation, POWER_ASSERT_INTERVAL
+ * re-asserts when the interval has passed, and POWER_ASSERT_ON_ERROR only
+ * re-asserts after a failed transaction (the board may have been unplugged
+ * and plugged back in with the 40mA default). The last two also re-assert
+ * whenever the previous attempt failed.
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ *
+ * Returns GHOSTLAB42REBOOT_OK if the power did not need to be re-asserted
+ */
+byte GhostLab42Reboot::assertDisplayPower(int displayID)
+{
+  if (powerPolicy == POWER_ASSERT_ALWAYS ||
+      powerAsserted[displayID] == false ||
+      (powerPolicy == POWER_ASSERT_INTERVAL &&
+       millis() - lastPowerAssert[displayID] >= powerInterval))
+  {
+    return setDisplayPowerMax(displayID);
+  }
+
+  return GHOSTLAB42REBOOT_OK;
+}
+
+/*
+ * Encodes the characters into a frame and sends it to the selected display
+ * All of the write() overloads end up here, none of them allocate
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * text      The characters to write
+ * length    Number of characters in text
+ * inFlash   Whether text lives in flash (PROGMEM) instead of RAM
+ */
+byte GhostLab42Reboot::writeText(int displayID, const char *text,
+                                 size_t length, bool inFlash)
+{
+  // Verify the display exists before attempting to write to it
+  if (verifyDisplayID(displayID) == false) return GHOSTLAB42REBOOT_ERROR_INVALID_DISPLAY;
+
+#if GHOSTLAB42REBOOT_STATS
+  LatencyTimer timer(statistics[displayID]);
+#endif
+
+  // Build the new frame on top of what the display is already showing
+  // Digits that the value does not reach keep their current contents
+  // Any string that goes over the number of digits gets cut off
+  byte frame[GHOSTLAB42REBOOT_DATA_REGISTERS];
+  memcpy(frame, frameBuffer[displayID], sizeof(frame));
+  encodeText(text, length, inFlash, frame, boards[displayID].digits);
+
+  // Only send the registers that actually changed
+  return commitFrame(displayID, frame);
+}
+
+/*
+ * Encodes characters into display bytes, one byte per digit
+ *
+ * Decimals are wrapped into the previous character's digit unless they are
+ * the first character or follow another decimal, in which case they get a
+ * digit of their own.
+ *
+ * Parameters:
+ * text     The characters to encode
+ * length   Number of characters in text
+ * inFlash  Whether text lives in flash (PROGMEM) instead of RAM
+ * glyphs   Receives the encoded digits
+ * capacity Number of digits that fit in glyphs, the rest get cut off
+ *
+ * Returns the number of digits that were encoded
+ */
+byte GhostLab42Reboot::encodeText(const char *text, size_t length, bool inFlash,
+                                  byte glyphs[], byte capacity)
+{
+  byte glyphCount = 0;
+
+  // Character array that stores the substring that is to be encoded
+  char substringValue[2] = {0, 0};
+
+  // Iterate over the text and encode the individual characters
+  for (size_t i = 0; i < length && glyphCount < capacity; i++)
+  {
+    char character = readCharacter(text, i, inFlash);
+    char nextCharacter = (i + 1 < length) ? readCharacter(text, i + 1, inFlash) : '\0';
+
+    // Determine how the character should be written
+    // Handle decimal as first character
+    if (character == '.' and (i == 0 || readCharacter(text, i - 1, inFlash) == '.'))
+    {
+      substringValue[0] = ' ';
+      substringValue[1] = character;
+    }
+    // Handle decimal after a regular character
+    else if (nextCharacter == '.')
+    {
+      // There is a decimal, write it as part of the character
+      // Prepare the substring
+      substringValue[0] = character;
+      substringValue[1] = nextCharacter;
+
+      // Skip the decimal
+      i++;
+    }
+    else
+    {
+      // There isn't a decimal, write the character normally
+      // Prepare the substring
+      substringValue[0] = character;
+    }
+
+    // Encode the substring, dropping whatever does not fit
+    byte characterGlyphs[2];
+    byte characterGlyphCount = encodeCharacter(substringValue, characterGlyphs);
+    for (byte j = 0; j < characterGlyphCount && glyphCount < capacity; j++)
+    {
+      glyphs[glyphCount++] = characterGlyphs[j];
+    }
+
+    // Clear out the substring array
+    memset(&substringValue[0], 0, sizeof(substringValue));
+  }
+
+  return glyphCount;
+}
+
+/*
+ * Reads a single character out of RAM or flash
+ *
+ * Parameters:
+ * text    The characters to read from
+ * index   Index of the character to read
+ * inFlash Whether text lives in flash (PROGMEM) instead of RAM
+ */
+char GhostLab42Reboot::readCharacter(const char *text, size_t index, bool inFlash)
+{
+  if (inFlash) return pgm_read_byte(text + index);
+  return text[index];
+}
+
+#if GHOSTLAB42REBOOT_SCROLL_LENGTH > 0
+/*
+ * Encodes the text for a scroll and shows the first step of it
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * text      The characters to scroll
+ * length    Number of characters in text
+ * inFlash   Whether text lives in flash (PROGMEM) instead of RAM
+ * msPerStep Milliseconds between each step
+ */
+byte GhostLab42Reboot::startScroll(int displayID, const char *text, size_t length,
+                                   bool inFlash, unsigned long msPerStep)
+{
+  // Verify the display exists before attempting to scroll on it
+  if (verifyDisplayID(displayID) == false) return GHOSTLAB42REBOOT_ERROR_INVALID_DISPLAY;
+
+  Scroll &scroll = scrolls[displayID];
+  scroll.length = encodeText(text, length, inFlash, scroll.glyphs,
+                             GHOSTLAB42REBOOT_SCROLL_LENGTH);
+  scroll.position = 0;
+  scroll.stepInterval = msPerStep;
+  scroll.nextStep = millis();
+  scroll.active = (scroll.length > 0);
+
+  // Show the first step right away
+  if (scroll.active == false) return GHOSTLAB42REBOOT_OK;
+  return stepScroll(displayID);
+}
+
+/*
+ * Shows the current window of a scroll and moves it along by one digit
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+byte GhostLab42Reboot::stepScroll(int displayID)
+{
+  Scroll &scroll = scrolls[displayID];
+  byte width = boards[displayID].digits;
+
+  // Copy the window into the frame, anything past the end of the text is
+  // left blank
+  // The window can run past 255 near the end of a full length scroll
+  byte frame[GHOSTLAB42REBOOT_DATA_REGISTERS];
+  memcpy(frame, frameBuffer[displayID], sizeof(frame));
+  for (byte i = 0; i < width; i++)
+  {
+    uint16_t glyphIndex = scroll.position + i;
+    frame[i] = (glyphIndex < scroll.length) ? scroll.glyphs[glyphIndex] : 0x00;
+  }
+  byte status = commitFrame(displayID, frame);
+
+  // Start over once the text has moved all the way across
+  scroll.position++;
+  if (scroll.position >= scroll.length) scroll.position = 0;
+
+  // Schedule off of the last step rather than now so the speed stays steady,
+  // unless we have fallen so far behind that we would have to catch up
+  scroll.nextStep += scroll.stepInterval;
+  if ((long)(millis() - scroll.nextStep) >= (long)scroll.stepInterval)
+  {
+    scroll.nextStep = millis();
+  }
+
+  return status;
+}
+#endif
+
+/*
+ * Moves a brightness fade along to where it should be by now
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+byte GhostLab42Reboot::stepFade(int displayID)
+{
+  Fade &fade = fades[displayID];
+
+  // How far along the fade is, from 0 to 256
+  unsigned long elapsed = millis() - fade.startTime;
+  uint16_t progress = 256;
+  if (elapsed < fade.duration)
+  {
+    progress = (uint32_t)elapsed * 256 / fade.duration;
+  }
+
+  // Bend the progress with the easing curve (quadratic, in 8.8 fixed point)
+  uint16_t eased = progress;
+  uint16_t remaining = 256 - progress;
+  if (fade.easing == EASE_IN)
+  {
+    eased = (uint32_t)progress * progress / 256;
+  }
+  else if (fade.easing == EASE_OUT)
+  {
+    eased = 256 - (uint32_t)remaining * remaining / 256;
+  }
+  else if (fade.easing == EASE_IN_OUT)
+  {
+    if (progress < 128) eased = (uint32_t)progress * progress / 128;
+    else eased = 256 - (uint32_t)remaining * remaining / 128;
+  }
+
+  int brightness = fade.startBrightness +
+    ((long)(fade.targetBrightness - fade.startBrightness) * eased) / 256;
+
+  if (progress >= 256) fade.active = false;
+
+  return writeBrightness(displayID, brightness, true);
+}
+
+/*
+ * Sets the brightness level of the display through the light correction
+ * lookup table
+ *
+ * Parameters:
+ * displayID     Unique identifier for the display
+ * brightness    The dimming level percentage as an int 0 - 100
+ * onlyIfChanged Skip the write if the display is already at this level
+ */
+byte GhostLab42Reboot::writeBrightness(int displayID, int brightness, bool onlyIfChanged)
+{
+  brightness = constrain(brightness, 0, 100);
+  brightnessLevels[displayID] = brightness;
+
+  // Several percentages share the same value in the lookup table
+  byte pwmValue = lightCorrectionTable[brightness];
+  if (onlyIfChanged && pwmValue == pwmValues[displayID])
+  {
+#if GHOSTLAB42REBOOT_STATS
+    statistics[displayID].skippedWrites++;
+#endif
+    return GHOSTLAB42REBOOT_OK;
+  }
+
+  // Make sure the maximum current for the display is not exceeded
+  // Bringing back a display that was just found again on the way sends the
+  // new brightness along with everything else
+  pwmValues[displayID] = PWM_UNKNOWN;
+  byte status = assertDisplayPower(displayID);
+  if (status != GHOSTLAB42REBOOT_OK || pwmValues[displayID] == pwmValue) return status;
+
+  // Tell the lighting effect register to display at the desired
+  // brightness level with values from the light correction lookup table
+  pwmValues[displayID] = pwmValue;
+  return writeRegister(displayID, IS31FL3730_PWM_Register, pwmValue);
+}
+
+/*
+ * Sends the registers that differ between the new frame and the shadow copy
+ * of the display, then updates the display
+ *
+ * The data registers (0x01 - 0x0B) sit right in front of the Update Column
+ * Register (0x0C) and the register index auto-increments, so everything from
+ * the first changed register up to and including the Update Column Register
+ * goes out in a single transaction. If nothing changed, the display is left
+ * alone entirely. Between beginFrame() and endFrame() the Update Column
+ * Register is left for endFrame().
+ *
+ * The frame is merged into the shadow copy before anything is sent, with
+ * the registers that changed marked dirty until they go out. So a display
+ * that is found again along the way gets the new frame in the burst that
+ * brings it back, and the display can be brought back up to date after an
+ * error
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * frame     The full set of data register values the display should show
+ */
+byte GhostLab42Reboot::commitFrame(int displayID, const byte frame[])
+{
+  byte *shadow = frameBuffer[displayID];
+
+  // Find the first register that changed
+  int firstDirty = -1;
+  for (int i = 0; i < GHOSTLAB42REBOOT_DATA_REGISTERS; i++)
+  {
+    if (frame[i] != shadow[i] || bitRead(dirtyRegisters[displayID], i))
+    {
+      firstDirty = i;
+      break;
+    }
+  }
+
+  // Nothing to do if the display already shows this frame
+  if (firstDirty < 0)
+  {
+#if GHOSTLAB42REBOOT_STATS
+    statistics[displayID].skippedWrites++;
+#endif
+    return GHOSTLAB42REBOOT_OK;
+  }
+
+  for (int i = firstDirty; i < GHOSTLAB42REBOOT_DATA_REGISTERS; i++)
+  {
+    shadow[i] = frame[i];
+    bitSet(dirtyRegisters[displayID], i);
+  }
+
+  // Make sure the maximum current for the display is not exceeded
+  byte status = assertDisplayPower(displayID);
+  if (status != GHOSTLAB42REBOOT_OK) return status;
+
+  // Bringing back a display that was just found again sends all of it
+  if (dirtyRegisters[displayID] == 0x0000) return GHOSTLAB42REBOOT_OK;
+
+  // Write the display data in the temporary registers, starting at the first
+  // change and running all the way up to the last data register
+  byte data[GHOSTLAB42REBOOT_MAX_TRANSACTION_LENGTH];
+  byte length = 0;
+  data[length++] = IS31FL3730_Data_Registers + firstDirty;
+  for (int i = firstDirty; i < GHOSTLAB42REBOOT_DATA_REGISTERS; i++)
+  {
+    data[length++] = shadow[i];
+  }
+
+  // The next register is the Update Column Register, so keep going to
+  // transfer the display data from the temporary registers to the display
+  // Send any value to initate the display (value ignored)
+  // In the middle of a frame, endFrame() does this for all of the displays
+  // at once instead
+  if (frameOpen)
+  {
+    updatePending[displayID] = true;
+  }
+  else
+  {
+    data[length++] = 0x00;
+  }
+
+  dirtyRegisters[displayID] = 0x0000;
+  return transmit(displayID, data, length);
+}
+
+/*
+ * Blanks the shadow copy of the selected display and puts its brightness
+ * back to full, the way a reset leaves the display
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+void GhostLab42Reboot::clearShadow(int displayID)
+{
+  memset(frameBuffer[displayID], 0x00, sizeof(frameBuffer[displayID]));
+  dirtyRegisters[displayID] = 0x0000;
+  brightnessLevels[displayID] = 100;
+  pwmValues[displayID] = IS31FL3730_PWM_Default;
+}
+
+/*
+ * Writes a single register on the selected display
+ *
+ * Parameters:
+ * displayID     Unique identifier for the display
+ * registerIndex Index of the register in the IS31FL3730
+ * value         The value to write to the register
+ */
+byte GhostLab42Reboot::writeRegister(int displayID, byte registerIndex, byte value)
+{
+  byte data[] = {registerIndex, value};
+  return transmit(displayID, data, sizeof(data));
+}
+
+/*
+ * Sends a transaction to the selected display, or queues it in async mode
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * data      The register index followed by the values for the registers
+ * length    Number of bytes in data
+ *
+ * Returns the result of the transaction, or GHOSTLAB42REBOOT_OK once it is
+ * queued
+ */
+byte GhostLab42Reboot::transmit(int displayID, const byte data[], byte length)
+{
+  // Don't bother with displays that aren't there, the shadow copy already
+  // has everything needed to bring them back
+  // Sketches that never call update() still get them back from here
+  if (bitRead(presentDisplays, displayID) == 0)
+  {
+    probeMissingDisplays();
+    if (bitRead(presentDisplays, displayID) == 0) return GHOSTLAB42REBOOT_ERROR_NOT_PRESENT;
+
+    // Callers update the shadow copy and brightness before they get here, so
+    // once the display has been brought back, anything but a reset has
+    // already gone out with it. If bringing it back failed, everything is
+    // dirty again and this goes out on its own
+    if (dirtyRegisters[displayID] == 0x0000 && length > 0 &&
+        data[0] != IS31FL3730_Reset_Register)
+    {
+      return GHOSTLAB42REBOOT_OK;
+    }
+  }
+
+#if GHOSTLAB42REBOOT_QUEUE_LENGTH > 0
+  if (asyncMode == false) return sendTransaction(displayID, data, length);
+
+  // Make room by sending the oldest transaction if the queue is full, along
+  // with any retries it still has to go through
+  // Its result still goes to the completion callback
+  while (queueCount == GHOSTLAB42REBOOT_QUEUE_LENGTH) sendNextTransaction(true);
+
+  Transaction &transaction = queue[(queueHead + queueCount) % GHOSTLAB42REBOOT_QUEUE_LENGTH];
+  transaction.displayID = displayID;
+  transaction.length = length;
+  memcpy(transaction.data, data, length);
+  queueCount++;
+  return GHOSTLAB42REBOOT_OK;
+#else
+  return sendTransaction(displayID, data, length);
+#endif
+}
+
+/*
+ * Sends a transaction to the selected display right away, trying again
+ * according to the retry policy if it fails
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * data      The register index followed by the values for the registers
+ * length    Number of bytes in data
+ */
+byte GhostLab42Reboot::sendTransaction(int displayID, const byte data[], byte length)
+{
+  // The display may have gone missing while this was queued
+  if (bitRead(presentDisplays, displayID) == 0) return GHOSTLAB42REBOOT_ERROR_NOT_PRESENT;
+
+  byte status = transmitToBoard(displayID, data, length);
+  bool busHung = (status == GHOSTLAB42REBOOT_ERROR_TIMEOUT);
+
+  // Sending a transaction that is too long again won't make it any shorter
+  // setRetryPolicy() keeps the doubling well within an unsigned long
+  unsigned long backoff = retryBackoff;
+  for (byte retry = 0; retry < retries && status != GHOSTLAB42REBOOT_OK &&
+       status != GHOSTLAB42REBOOT_ERROR_TOO_LONG; retry++)
+  {
+    countError(displayID, status);
+    waitMicroseconds(backoff);
+    backoff *= 2;
+    status = transmitToBoard(displayID, data, length);
+    if (status == GHOSTLAB42REBOOT_ERROR_TIMEOUT) busHung = true;
+  }
+
+  finishTransaction(displayID, status);
+  if (busHung) recoverBus(displayID);
+  return status;
+}
+
+/*
+ * Hands a single attempt at a transaction to the display's bus
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * data      The register index followed by the values for the registers
+ * length    Number of bytes in data
+ */
+byte GhostLab42Reboot::transmitToBoard(int displayID, const byte data[], byte length)
+{
+#if GHOSTLAB42REBOOT_STATS
+  statistics[displayID].transactions++;
+  statistics[displayID].bytes += length;
+#endif
+
+  const GhostLab42RebootBoard &board = boards[displayID];
+
+#if GHOSTLAB42REBOOT_TRACE_LENGTH > 0
+  unsigned long start = micros();
+#endif
+
+  GHOSTLAB42REBOOT_TRANSACTION_BEGIN(board.address);
+  byte status = board.bus->transmit(board.address, data, length);
+  GHOSTLAB42REBOOT_TRANSACTION_END(board.address, status);
+
+#if GHOSTLAB42REBOOT_TRACE_LENGTH > 0
+  traceTransaction(start, board.address, (length > 0) ? data[0] : 0x00, length, status);
+#endif
+
+  return status;
+}
+
+#if GHOSTLAB42REBOOT_TRACE_LENGTH > 0
+/*
+ * Adds a transaction to the trace, writing over the oldest one once the
+ * trace is full
+ *
+ * Parameters:
+ * timestamp     micros() when the transaction started
+ * address       I2C address of the display
+ * firstRegister The register index the transaction started at
+ * length        Number of bytes in the transaction, counting the register index
+ * status        The result from the bus
+ */
+void GhostLab42Reboot::traceTransaction(unsigned long timestamp, byte address,
+                                        byte firstRegister, byte length, byte status)
+{
+  TraceRecord &record = trace[(traceHead + traceCount) % GHOSTLAB42REBOOT_TRACE_LENGTH];
+  record.timestamp = timestamp;
+  record.address = address;
+  record.firstRegister = firstRegister;
+  record.length = length;
+  record.status = status;
+
+  if (traceCount < GHOSTLAB42REBOOT_TRACE_LENGTH)
+  {
+    traceCount++;
+  }
+  else
+  {
+    traceHead = (traceHead + 1) % GHOSTLAB42REBOOT_TRACE_LENGTH;
+    traceDropped++;
+  }
+}
+#endif
+
+#if GHOSTLAB42REBOOT_QUEUE_LENGTH > 0
+/*
+ * Sends every transaction in the queue, waiting out the backoff of any
+ * retries
+ *
+ * Returns the first error from the transactions that were sent
+ */
+byte GhostLab42Reboot::sendQueue()
+{
+  byte status = GHOSTLAB42REBOOT_OK;
+  while (queueCount > 0)
+  {
+    byte transactionStatus = sendNextTransaction(true);
+    if (status == GHOSTLAB42REBOOT_OK) status = transactionStatus;
+  }
+  return status;
+}
+
+/*
+ * Makes a single attempt at the oldest transaction in the queue
+ *
+ * A failed attempt that can still be retried leaves the transaction at the
+ * front of the queue, due again once its backoff is over, and isn't
+ * reported until the last attempt
+ *
+ * Parameters:
+ * wait Whether to wait for a retry that isn't due yet, rather than leaving
+ *      it for a later call
+ *
+ * Returns the result of the transaction once it is done with, otherwise
+ * GHOSTLAB42REBOOT_OK
+ */
+byte GhostLab42Reboot::sendNextTransaction(bool wait)
+{
+  Transaction &transaction = queue[queueHead];
+  int displayID = transaction.displayID;
+
+  if (queueAttempts > 0)
+  {
+    long remaining = (long)(queueRetryTime - micros());
+    if (remaining > 0)
+    {
+      if (wait == false) return GHOSTLAB42REBOOT_OK;
+      waitMicroseconds(remaining);
+    }
+  }
+
+  // The display may have gone missing while this was queued
+  byte status = GHOSTLAB42REBOOT_ERROR_NOT_PRESENT;
+  if (bitRead(presentDisplays, displayID))
+  {
+    status = transmitToBoard(displayID, transaction.data, transaction.length);
+    if (status == GHOSTLAB42REBOOT_ERROR_TIMEOUT) queueBusHung = true;
+
+    // Sending a transaction that is too long again won't make it any shorter
+    if (status != GHOSTLAB42REBOOT_OK && status != GHOSTLAB42REBOOT_ERROR_TOO_LONG &&
+        queueAttempts < retries)
+    {
+      countError(displayID, status);
+      queueRetryTime = micros() + ((unsigned long)retryBackoff << queueAttempts);
+      queueAttempts++;
+      return GHOSTLAB42REBOOT_OK;
+    }
+  }
+
+  // Take it off the queue first in case the completion callback queues more
+  bool busHung = queueBusHung;
+  queueHead = (queueHead + 1) % GHOSTLAB42REBOOT_QUEUE_LENGTH;
+  queueCount--;
+  queueAttempts = 0;
+  queueBusHung = false;
+
+  if (status == GHOSTLAB42REBOOT_ERROR_NOT_PRESENT) return status;
+
+  finishTransaction(displayID, status);
+  if (busHung) recoverBus(displayID);
+  return status;
+}
+#endif
+
+/*
+ * Handles the result of a transaction to the selected display
+ *
+ * The shadow copy and power state are updated as soon as a transaction is
+ * sent or queued, so a failure has to undo that
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * status    The result from the bus, the same as Wire.endTransmission()
+ *           (0 is success)
+ */
+void GhostLab42Reboot::finishTransaction(int displayID, byte status)
+{
+  if (status != GHOSTLAB42REBOOT_OK)
+  {
+    countError(displayID, status);
+
+    // The board may have been unplugged, so it could come back with the
+    // default current and a blank display
+    powerAsserted[displayID] = false;
+    dirtyRegisters[displayID] = GHOSTLAB42REBOOT_ALL_REGISTERS_DIRTY;
+    pwmValues[displayID] = PWM_UNKNOWN;
+  }
+
+  // Nobody answered at the display's address, so stop talking to it until
+  // it is found again
+  if (status == GHOSTLAB42REBOOT_ERROR_NACK_ADDRESS) bitClear(presentDisplays, displayID);
+
+  if (completionCallback != NULL) completionCallback(displayID, status);
+}
+
+/*
+ * Brings back every display on the same bus as the selected display, after
+ * a transaction to it hung the bus
+ *
+ * The bus was cleared and restarted, but whatever was holding it was most
+ * likely a board being plugged in, so every display on the bus gets
+ * everything it should be showing again, even if a retry went through
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+void GhostLab42Reboot::recoverBus(int displayID)
+{
+  for (int i = 0; i < displayCount; i++)
+  {
+    if (boards[i].bus == boards[displayID].bus) bitSet(replayDisplays, i);
+  }
+  replayPendingDisplays();
+}
+
+/*
+ * Counts a failed attempt to talk to the selected display
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * status    The result from the bus, the same as Wire.endTransmission()
+ */
+void GhostLab42Reboot::countError(int displayID, byte status)
+{
+  GhostLab42RebootErrorCounts &counts = errorCounts[displayID];
+  if (status == GHOSTLAB42REBOOT_ERROR_NACK_ADDRESS) counts.nackAddress++;
+  else if (status == GHOSTLAB42REBOOT_ERROR_NACK_DATA) counts.nackData++;
+  else counts.other++;
+
+#if GHOSTLAB42REBOOT_STATS
+  statistics[displayID].errors++;
+#endif
+}
+
+/*
+ * Checks whether anything answers at the display's address
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+bool GhostLab42Reboot::probeDisplay(int displayID)
+{
+  // A transaction with nothing in it is just the address
+  byte nothing = 0;
+  return (transmitToBoard(displayID, &nothing, 0) == GHOSTLAB42REBOOT_OK);
+}
+
+/*
+ * Looks for the displays that have gone missing, once every
+ * GHOSTLAB42REBOOT_PROBE_INTERVAL milliseconds, and brings back whatever the
+ * ones that answer should be showing
+ */
+void GhostLab42Reboot::probeMissingDisplays()
+{
+  unsigned long now = millis();
+  if (now - lastProbe < GHOSTLAB42REBOOT_PROBE_INTERVAL) return;
+
+  // Replaying goes back through transmit(), so this has to be set first
+  lastProbe = now;
+  for (int i = 0; i < displayCount; i++)
+  {
+    if (bitRead(presentDisplays, i) == 0 && probeDisplay(i))
+    {
+      bitSet(presentDisplays, i);
+      replayDisplay(i);
+    }
+  }
+}
+
+/*
+ * Sends everything the display should be showing, for when it has been
+ * plugged back in
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+void GhostLab42Reboot::replayDisplay(int displayID)
+{
+  // The display came back with the 40mA default, so the data burst has to be
+  // preceded by the current limit no matter what the power policy is
+  powerAsserted[displayID] = false;
+
+  // Every data register and the Update Column Register in one burst
+  byte frame[GHOSTLAB42REBOOT_DATA_REGISTERS];
+  memcpy(frame, frameBuffer[displayID], sizeof(frame));
+  dirtyRegisters[displayID] = GHOSTLAB42REBOOT_ALL_REGISTERS_DIRTY;
+  if (commitFrame(displayID, frame) != GHOSTLAB42REBOOT_OK) return;
+
+  // Then the brightness
+  pwmValues[displayID] = lightCorrectionTable[brightnessLevels[displayID]];
+  writeRegister(displayID, IS31FL3730_PWM_Register, pwmValues[displayID]);
+}
+
+/*
+ * Replays every display that is waiting for it after a bus hang
+ *
+ * A replay that hangs the bus again only marks the displays again, so they
+ * are left for the next update() instead of being replayed over and over
+ */
+void GhostLab42Reboot::replayPendingDisplays()
+{
+  if (replaying) return;
+
+  replaying = true;
+  for (int i = 0; i < displayCount; i++)
+  {
+    if (bitRead(replayDisplays, i))
+    {
+      bitClear(replayDisplays, i);
+
+      // Missing displays get replayed when they are found again
+      if (bitRead(presentDisplays, i)) replayDisplay(i);
+    }
+  }
+  replaying = false;
+}
+
+/*
+ * Converts characters into the appropriate bytes for display (gfedcba format)
+ *
+ * Parameters:
+ * displayCharacters The character(s) to be converted into a byte for the
+ *                   display. Some characters like "W" need multiple digits.
+ * glyphs            Receives the encoded digit(s), room for two is needed
+ *
+ * Returns the number of digits the character(s) take up
+ */
+byte GhostLab42Reboot::encodeCharacter(char displayCharacters[], byte glyphs[])
+{
+  // Look the character up in the glyph table
+  // Anything outside of the table turns into a blank for that character space
+  byte character = displayCharacters[0];
+  uint16_t glyph = 0x0000;
+  if (character < sizeof(glyphTable) / sizeof(glyphTable[0]))
+  {
+    glyph = pgm_read_word(&glyphTable[character]);
+  }
+
+  // Sometimes decimals are involved, so we need something to add it
+  // Unrecognized characters stay blank, even with a decimal
+  byte decimalOffset = 0x00; // No decimal to add
+  if (displayCharacters[1] == '.' && (glyph != 0x0000 || character == ' '))
+  {
+    // Add a decimal
+    decimalOffset = 0x80;
+  }
+
+  // Some characters like "M" and "W" need an extra digit in front
+  byte glyphCount = 0;
+  if (highByte(glyph) != 0x00) glyphs[glyphCount++] = highByte(glyph);
+
+  glyphs[glyphCount++] = lowByte(glyph) | decimalOffset;
+  return glyphCount;
+}
+
+/******************************************************************************
+ *                                 Print Sink                                 *
+ ******************************************************************************/
+
+/*
+ * Parameters:
+ * reboot The library instance that the printed characters go to
+ */
+GhostLab42RebootPrint::GhostLab42RebootPrint(GhostLab42Reboot &reboot)
+  : reboot(reboot), displayID(-1), length(0), lastCharacter('\0') {}
+
+/*
+ * Encodes a single character into the digits waiting to be shown
+ *
+ * Decimals are wrapped into the previous character's digit the same way
+ * write() does it, even when they arrive in a later call. A newline shows
+ * everything printed since the last one, and carriage returns are ignored.
+ *
+ * Parameters:
+ * character The character to encode
+ *
+ * Returns 1, the character is always taken even if it does not fit
+ */
+size_t GhostLab42RebootPrint::write(uint8_t character)
+{
+  if (character == '\r') return 1;
+
+  if (character == '\n')
+  {
+    commit();
+    return 1;
+  }
+
+  if (character == '.' && lastCharacter != '\0' && lastCharacter != '.')
+  {
+    // Wrap the decimal into the digit in front of it, if that one fit
+    // Encoding the character again with the decimal keeps unrecognized
+    // characters blank, the same as write()
+    if (length <= GHOSTLAB42REBOOT_DATA_REGISTERS)
+    {
+      char characters[2] = {lastCharacter, '.'};
+      byte characterGlyphs[2];
+      byte characterGlyphCount = reboot.encodeCharacter(characters, characterGlyphs);
+      glyphs[length - 1] = characterGlyphs[characterGlyphCount - 1];
+    }
+  }
+  else
+  {
+    // Decimals that start the line or follow another decimal get a digit of
+    // their own
+    char characters[2] = {(char)character, 0};
+    if (character == '.')
+    {
+      characters[0] = ' ';
+      characters[1] = '.';
+    }
+
+    byte characterGlyphs[2];
+    byte characterGlyphCount = reboot.encodeCharacter(characters, characterGlyphs);
+    for (byte i = 0; i < characterGlyphCount; i++)
+    {
+      if (length < GHOSTLAB42REBOOT_DATA_REGISTERS) glyphs[length] = characterGlyphs[i];
+      if (length < 0xFF) length++;
+    }
+  }
+
+  lastCharacter = character;
+  return 1;
+}
+
+/*
+ * Shows everything printed since the last line was finished
+ */
+void GhostLab42RebootPrint::flush()
+{
+  commit();
+}
+
+/*
+ * Shows everything printed since the last line was finished, blanking the
+ * rest of the display
+ *
+ * Returns GHOSTLAB42REBOOT_OK if there was nothing to show, otherwise the
+ * result of showing it
+ */
+byte GhostLab42RebootPrint::commit()
+{
+  if (lastCharacter == '\0') return GHOSTLAB42REBOOT_OK;
+
+  byte digits = min(length, (byte)GHOSTLAB42REBOOT_DATA_REGISTERS);
+  memset(glyphs + digits, 0x00, GHOSTLAB42REBOOT_DATA_REGISTERS - digits);
+  length = 0;
+  lastCharacter = '\0';
 
-  // Numbers
-  if      (displayCharacters[0] == '0') Wire.write(0x3F + decimalOffset);
-  else if (displayCharacters[0] == '1') Wire.write(0x06 + decimalOffset);
-  else if (displayCharacters[0] == '2') Wire.write(0x5B + decimalOffset);
-  else if (displayCharacters[0] == '3') Wire.write(0x4F + decimalOffset);
-  else if (displayCharacters[0] == '4') Wire.write(0x66 + decimalOffset);
-  else if (displayCharacters[0] == '5') Wire.write(0x6D + decimalOffset);
-  else if (displayCharacters[0] == '6') Wire.write(0x7D + decimalOffset);
-  else if (displayCharacters[0] == '7') Wire.write(0x07 + decimalOffset);
-  else if (displayCharacters[0] == '8') Wire.write(0x7F + decimalOffset);
-  else if (displayCharacters[0] == '9') Wire.write(0x6F + decimalOffset);
-
-  // Letters
-  else if (displayCharacters[0] == 'A' || displayCharacters[0] == 'a') Wire.write(0x77 + decimalOffset);
-  else if (displayCharacters[0] == 'B' || displayCharacters[0] == 'b') Wire.write(0x7C + decimalOffset);
-  else if (displayCharacters[0] == 'C' || displayCharacters[0] == 'c') Wire.write(0x39 + decimalOffset);
-  else if (displayCharacters[0] == 'D' || displayCharacters[0] == 'd') Wire.write(0x5E + decimalOffset);
-  else if (displayCharacters[0] == 'E' || displayCharacters[0] == 'e') Wire.write(0x79 + decimalOffset);
-  else if (displayCharacters[0] == 'F' || displayCharacters[0] == 'f') Wire.write(0x71 + decimalOffset);
-  else if (displayCharacters[0] == 'G' || displayCharacters[0] == 'g') Wire.write(0x3D + decimalOffset);
-  else if (displayCharacters[0] == 'H' || displayCharacters[0] == 'h') Wire.write(0x76 + decimalOffset);
-  else if (displayCharacters[0] == 'I' || displayCharacters[0] == 'i') Wire.write(0x06 + decimalOffset);
-  else if (displayCharacters[0] == 'J' || displayCharacters[0] == 'j') Wire.write(0x1E + decimalOffset);
-  else if (displayCharacters[0] == 'K' || displayCharacters[0] == 'k') Wire.write(0x76 + decimalOffset);
-  else if (displayCharacters[0] == 'L' || displayCharacters[0] == 'l') Wire.write(0x38 + decimalOffset);
-  else if (displayCharacters[0] == 'M' || displayCharacters[0] == 'm')
-  {
-      Wire.write(0x33);
-      Wire.write(0x27 + decimalOffset);
-  }
-  else if (displayCharacters[0] == 'N' || displayCharacters[0] == 'n') Wire.write(0x54 + decimalOffset);
-  else if (displayCharacters[0] == 'O' || displayCharacters[0] == 'o') Wire.write(0x3F + decimalOffset);
-  else if (displayCharacters[0] == 'P' || displayCharacters[0] == 'p') Wire.write(0x73 + decimalOffset);
-  else if (displayCharacters[0] == 'Q' || displayCharacters[0] == 'q') Wire.write(0x67 + decimalOffset);
-  else if (displayCharacters[0] == 'R' || displayCharacters[0] == 'r') Wire.write(0x50 + decimalOffset);
-  else if (displayCharacters[0] == 'S' || displayCharacters[0] == 's') Wire.write(0x6D + decimalOffset);
-  else if (displayCharacters[0] == 'T' || displayCharacters[0] == 't') Wire.write(0x78 + decimalOffset);
-  else if (displayCharacters[0] == 'U' || displayCharacters[0] == 'u') Wire.write(0x3E + decimalOffset);
-  else if (displayCharacters[0] == 'V' || displayCharacters[0] == 'v') Wire.write(0x3E + decimalOffset);
-  else if (displayCharacters[0] == 'W' || displayCharacters[0] == 'w')
-  {
-      Wire.write(0x3C);
-      Wire.write(0x1E + decimalOffset);
-  }
-  else if (displayCharacters[0] == 'X' || displayCharacters[0] == 'x') Wire.write(0x76 + decimalOffset);
-  else if (displayCharacters[0] == 'Y' || displayCharacters[0] == 'y') Wire.write(0x6E + decimalOffset);
-  else if (displayCharacters[0] == 'Z' || displayCharacters[0] == 'z') Wire.write(0x5B + decimalOffset);
-
-  // Symbols
-  else if (displayCharacters[0] == '?') Wire.write(0xA3);
-  else if (displayCharacters[0] == '!') Wire.write(0x82);
-  else if (displayCharacters[0] == '-') Wire.write(0x40);
-  else if (displayCharacters[0] == ' ') Wire.write(0x00 + decimalOffset);
-
-  // Anything else turns into a blank for that character space
-  else Wire.write(0x00);
+  return reboot.writeSegments(displayID, glyphs, GHOSTLAB42REBOOT_DATA_REGISTERS, 0);
 }
@@ -10,21 +10,558 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include "GhostLab42RebootConfig.h"
+#include "GhostLab42RebootBus.h"
+
+// Number of displays in the Reboot board set
+#define GHOSTLAB42REBOOT_DISPLAY_COUNT 3
+
+// Each I2C has a unique bus address
+#define IS31FL3730_DIGIT_4_I2C_ADDRESS  0x63  // 4 digit IS31FL3730 display
+#define IS31FL3730_DIGIT_4S_I2C_ADDRESS 0x61  // 4 digit IS31FL3730 display (smaller)
+#define IS31FL3730_DIGIT_6_I2C_ADDRESS  0x60  // 6 digit IS31FL3730 display
+
+// Compile-time description of the boards in the Reboot board set, by display
+// ID. Only IDs 0 - 2 exist, so anything else does not compile
+template <int ID> struct GhostLab42RebootKitBoard;
+
+template <> struct GhostLab42RebootKitBoard<0>
+{
+  static const byte address = IS31FL3730_DIGIT_6_I2C_ADDRESS;
+  static const byte digits = 6;
+};
+
+template <> struct GhostLab42RebootKitBoard<1>
+{
+  static const byte address = IS31FL3730_DIGIT_4S_I2C_ADDRESS;
+  static const byte digits = 4;
+};
+
+template <> struct GhostLab42RebootKitBoard<2>
+{
+  static const byte address = IS31FL3730_DIGIT_4_I2C_ADDRESS;
+  static const byte digits = 4;
+};
+
+template <int ID> class GhostLab42RebootDisplay;
+
+// A single IS31FL3730 board
+struct GhostLab42RebootBoard
+{
+  byte address;             // I2C address of the board (0x60 - 0x63)
+  byte digits;              // Number of digits on the board's display
+  GhostLab42RebootBus *bus; // Bus the board is on, NULL for the library's bus
+};
+
+// Dirty register bitmask that forces every data register to be sent
+#define GHOSTLAB42REBOOT_ALL_REGISTERS_DIRTY 0x07FF
+
+// Status codes returned by the functions that talk to the displays
+// 0 - 5 come straight from the bus, the same as Wire.endTransmission()
+#define GHOSTLAB42REBOOT_OK                    0  // Success
+#define GHOSTLAB42REBOOT_ERROR_TOO_LONG        1  // Transaction too long for the bus
+#define GHOSTLAB42REBOOT_ERROR_NACK_ADDRESS    2  // Nothing answered at the address
+#define GHOSTLAB42REBOOT_ERROR_NACK_DATA       3  // The display did not take a byte
+#define GHOSTLAB42REBOOT_ERROR_OTHER           4  // Any other bus error
+#define GHOSTLAB42REBOOT_ERROR_TIMEOUT         5  // The bus timed out
+#define GHOSTLAB42REBOOT_ERROR_INVALID_DISPLAY 16 // No display with that ID
+#define GHOSTLAB42REBOOT_ERROR_NOT_PRESENT     17 // Display is missing, only the shadow copy was updated
+#define GHOSTLAB42REBOOT_ERROR_OVERFLOW        18 // Number did not fit, dashes are shown instead
+
+// Failed attempts to talk to a display, by what went wrong
+struct GhostLab42RebootErrorCounts
+{
+  unsigned long nackAddress; // Nothing answered at the address
+  unsigned long nackData;    // The display did not take a byte
+  unsigned long other;       // Anything else (too long, timeout, bus errors)
+};
+
+#if GHOSTLAB42REBOOT_STATS
+// Number of buckets in the latency histogram of each display
+#define GHOSTLAB42REBOOT_LATENCY_BUCKETS 16
+
+// What the library has sent to a display, see GHOSTLAB42REBOOT_STATS
+struct GhostLab42RebootStats
+{
+  unsigned long transactions;      // Attempts at sending a transaction, retries included
+  unsigned long bytes;             // Bytes sent, counting the register index but not the address
+  unsigned long skippedWrites;     // Writes that were left out because nothing changed
+  unsigned long suppressedWrites;  // Readings a GhostLab42RebootFilter kept off the display
+  unsigned long errors;            // Attempts that failed, retries included
+  unsigned long powerAsserts;      // Times the maximum display power was set
+
+  // Calls to write(), writeNumber(), setDisplayBrightness(), and
+  // resetDisplay() by how long they took. Bucket 0 holds the calls under a
+  // microsecond, bucket n the ones that took 2^(n-1) to 2^n - 1 microseconds,
+  // and the last bucket everything longer. Stops counting at 65535
+  uint16_t latency[GHOSTLAB42REBOOT_LATENCY_BUCKETS];
+};
+#endif
+
+#if GHOSTLAB42REBOOT_TRACE_LENGTH > 0
+// Version of the binary format written by dumpTrace(), and the size of each
+// record in it, see documentation/developer/trace.md
+#define GHOSTLAB42REBOOT_TRACE_VERSION     1
+#define GHOSTLAB42REBOOT_TRACE_RECORD_SIZE 8
+#endif
+
+// Most retries setRetryPolicy() takes, which keeps the longest wait before a
+// retry (backoff * 2^(retries - 1)) under 10 seconds
+#define GHOSTLAB42REBOOT_MAX_RETRIES 8
+
+// Called whenever a transaction to a display finishes
+// status is the result from the bus, the same as Wire.endTransmission()
+// (0 is success)
+typedef void (*GhostLab42RebootCallback)(int displayID, byte status);
+
+// How often the maximum display power gets re-asserted
+// The display driver resets to 40mA per segment when it loses power, which
+// is too much for the displays, so the library keeps setting it back
+enum GhostLab42RebootPowerPolicy
+{
+  POWER_ASSERT_ALWAYS,   // Before every operation
+  POWER_ASSERT_INTERVAL, // Once the interval has passed since the last time
+  POWER_ASSERT_ON_ERROR  // Only after a transaction to the display fails
+};
+
+// Which side of the display a number sits against
+enum GhostLab42RebootAlign
+{
+  ALIGN_LEFT,
+  ALIGN_RIGHT
+};
+
+// How a brightness fade speeds up and slows down along the way
+enum GhostLab42RebootEasing
+{
+  EASE_LINEAR,  // Same speed the whole way
+  EASE_IN,      // Starts slow, ends fast
+  EASE_OUT,     // Starts fast, ends slow
+  EASE_IN_OUT   // Starts and ends slow
+};
+
+class GhostLab42Reboot;
+
+// Print sink for a single display, see GhostLab42Reboot::on()
+//
+// Everything that Print can format goes straight into the display encoder,
+// one character at a time, and is shown once the line is finished (println()
+// or '\n') or the sink is flushed
+class GhostLab42RebootPrint : public Print
+{
+  public:
+    GhostLab42RebootPrint(GhostLab42Reboot &reboot);
+    size_t write(uint8_t character);
+    using Print::write;
+    void flush();
+    byte commit();
+  private:
+    friend class GhostLab42Reboot;
+
+    GhostLab42Reboot &reboot;
+    int displayID;
+
+    // Digits encoded since the last line was finished, how many there would
+    // be if they all fit, and the last character (for wrapping decimals)
+    byte glyphs[GHOSTLAB42REBOOT_DATA_REGISTERS];
+    byte length;
+    char lastCharacter;
+};
 
 class GhostLab42Reboot
 {
   public:
     GhostLab42Reboot();
-    void begin();
-    void write(int displayID, String value);
-    void resetDisplay(int displayID);
-    void setDisplayBrightness (int displayID, int brightness);
+    GhostLab42Reboot(GhostLab42RebootBus &bus);
+    byte begin(GhostLab42RebootPowerPolicy powerPolicy = POWER_ASSERT_ALWAYS,
+               unsigned long powerInterval = 1000);
+    byte begin(const GhostLab42RebootBoard boards[], byte boardCount,
+               GhostLab42RebootPowerPolicy powerPolicy = POWER_ASSERT_ALWAYS,
+               unsigned long powerInterval = 1000);
+    int getDisplayCount();
+    int getDisplayDigits(int displayID);
+    bool isPresent(int displayID);
+    byte write(int displayID, const String &value);
+    byte write(int displayID, const char *value);
+    byte write(int displayID, const char *value, size_t length);
+    byte write(int displayID, const uint8_t *value, size_t length);
+    byte write(int displayID, const __FlashStringHelper *value);
+    byte writeNumber(int displayID, int32_t value, byte decimals = 0,
+                     char padding = ' ', GhostLab42RebootAlign align = ALIGN_RIGHT);
+    byte writeFixed(int displayID, long mantissa, byte decimals,
+                    char padding = ' ', GhostLab42RebootAlign align = ALIGN_RIGHT);
+    byte writeFixed(int displayID, int mantissa, byte decimals,
+                    char padding = ' ', GhostLab42RebootAlign align = ALIGN_RIGHT)
+    {
+      return writeFixed(displayID, (long)mantissa, decimals, padding, align);
+    }
+    byte writeFixed(int displayID, double value, byte decimals,
+                    char padding = ' ', GhostLab42RebootAlign align = ALIGN_RIGHT);
+    byte writeSegments(int displayID, const byte segments[], byte count, byte offset = 0);
+    byte resetDisplay(int displayID);
+    byte setDisplayBrightness (int displayID, int brightness);
+    void beginFrame();
+    byte endFrame();
+    byte fadeTo(int displayID, int brightness, unsigned long duration,
+                GhostLab42RebootEasing easing = EASE_LINEAR);
+    bool isFading(int displayID);
+#if GHOSTLAB42REBOOT_SCROLL_LENGTH > 0
+    byte scroll(int displayID, const char *text, unsigned long msPerStep);
+    byte scroll(int displayID, const __FlashStringHelper *text, unsigned long msPerStep);
+    byte stopScroll(int displayID);
+    bool isScrolling(int displayID);
+#endif
+#if GHOSTLAB42REBOOT_QUEUE_LENGTH > 0
+    byte setAsyncMode(bool enabled);
+#endif
+    void setCompletionCallback(GhostLab42RebootCallback callback);
+    void setRetryPolicy(byte retries, unsigned int backoff);
+    GhostLab42RebootErrorCounts getErrorCounts(int displayID);
+    byte clearErrorCounts(int displayID);
+#if GHOSTLAB42REBOOT_STATS
+    const GhostLab42RebootStats &stats(int displayID);
+    byte clearStats(int displayID);
+#endif
+#if GHOSTLAB42REBOOT_TRACE_LENGTH > 0
+    size_t dumpTrace(Print &out);
+    void clearTrace();
+#endif
+    byte update();
+    byte flush();
+    bool isIdle();
+    GhostLab42RebootPrint &on(int displayID);
+
+    // Handle for one of the displays in the Reboot board set, ex.
+    // reboot.display<0>().write("123456")
+    template <int ID> GhostLab42RebootDisplay<ID> display()
+    {
+      return GhostLab42RebootDisplay<ID>(*this);
+    }
   private:
+    template <int ID> friend class GhostLab42RebootDisplay;
+    friend class GhostLab42RebootPrint;
+    friend class GhostLab42RebootCounter;
+    friend class GhostLab42RebootTimer;
+    friend class GhostLab42RebootFilter;
+
+    // The host benchmarks in extras/host time the private encoding directly
+    friend class GhostLab42RebootHostAccess;
+
+    void init(GhostLab42RebootBus &bus);
+
+    // A fully encoded transaction waiting to go out on the bus
+    struct Transaction
+    {
+      byte displayID;
+      byte length;
+      byte data[GHOSTLAB42REBOOT_MAX_TRANSACTION_LENGTH];
+    };
+
+#if GHOSTLAB42REBOOT_SCROLL_LENGTH > 0
+    // Text that is scrolling across a display, already encoded
+    struct Scroll
+    {
+      byte glyphs[GHOSTLAB42REBOOT_SCROLL_LENGTH];
+      byte length;
+      byte position;
+      bool active;
+      unsigned long stepInterval;
+      unsigned long nextStep;
+    };
+#endif
+
+    // A single attempt at a transaction, as kept in the trace
+    struct TraceRecord
+    {
+      unsigned long timestamp;
+      byte address;
+      byte firstRegister;
+      byte length;
+      byte status;
+    };
+
+    // Brightness fade running on a display
+    struct Fade
+    {
+      int startBrightness;
+      int targetBrightness;
+      unsigned long startTime;
+      unsigned long duration;
+      GhostLab42RebootEasing easing;
+      bool active;
+    };
+
     bool verifyDisplayID(int displayID);
-    void setDisplayPowerMin(int displayID);
-    void setDisplayPowerMax(int displayID);
-    void setupWireTransmission(int displayID);
-    void writeCharacter(char displayCharacters[]);
+    byte setDisplayPowerMin(int displayID);
+    byte setDisplayPowerMax(int displayID);
+    byte assertDisplayPower(int displayID);
+    byte writeText(int displayID, const char *text, size_t length, bool inFlash);
+    byte writeDigits(int displayID, bool negative, uint32_t magnitude, byte decimals,
+                     char padding, GhostLab42RebootAlign align);
+    byte writeOverflow(int displayID);
+    byte countNumberDigits(bool negative, uint32_t magnitude, byte decimals);
+    byte encodeText(const char *text, size_t length, bool inFlash,
+                    byte glyphs[], byte capacity);
+    char readCharacter(const char *text, size_t index, bool inFlash);
+#if GHOSTLAB42REBOOT_SCROLL_LENGTH > 0
+    byte startScroll(int displayID, const char *text, size_t length,
+                     bool inFlash, unsigned long msPerStep);
+    byte stepScroll(int displayID);
+#endif
+    byte stepFade(int displayID);
+    byte writeBrightness(int displayID, int brightness, bool onlyIfChanged);
+    byte commitFrame(int displayID, const byte frame[]);
+    void clearShadow(int displayID);
+    byte writeRegister(int displayID, byte registerIndex, byte value);
+    byte transmit(int displayID, const byte data[], byte length);
+    byte sendTransaction(int displayID, const byte data[], byte length);
+    byte transmitToBoard(int displayID, const byte data[], byte length);
+#if GHOSTLAB42REBOOT_TRACE_LENGTH > 0
+    void traceTransaction(unsigned long timestamp, byte address,
+                          byte firstRegister, byte length, byte status);
+#endif
+#if GHOSTLAB42REBOOT_QUEUE_LENGTH > 0
+    byte sendQueue();
+    byte sendNextTransaction(bool wait);
+#endif
+    void finishTransaction(int displayID, byte status);
+    void recoverBus(int displayID);
+    void countError(int displayID, byte status);
+    bool probeDisplay(int displayID);
+    void probeMissingDisplays();
+    void replayDisplay(int displayID);
+    void replayPendingDisplays();
+    byte encodeCharacter(char displayCharacters[], byte glyphs[]);
+
+    // Where the transactions to the displays go unless a board has a bus of
+    // its own
+    GhostLab42RebootBus *bus;
+
+    // Every board that was set up by begin(), indexed by display ID
+    GhostLab42RebootBoard boards[GHOSTLAB42REBOOT_MAX_DISPLAYS];
+    byte displayCount;
+
+    // Bitmap of the displays that answered the last time the library talked
+    // to them, and the last time the missing ones were looked for
+    uint16_t presentDisplays;
+    unsigned long lastProbe;
+
+    // Bitmap of the displays that need everything sent again because their
+    // bus hung, and whether that is already happening
+    uint16_t replayDisplays;
+    bool replaying;
+
+    // Shadow copy of the data registers of each display
+    byte frameBuffer[GHOSTLAB42REBOOT_MAX_DISPLAYS][GHOSTLAB42REBOOT_DATA_REGISTERS];
+
+    // Data registers that must be resent regardless of the shadow copy
+    uint16_t dirtyRegisters[GHOSTLAB42REBOOT_MAX_DISPLAYS];
+
+    // Power policy and the last time each display had its power asserted
+    GhostLab42RebootPowerPolicy powerPolicy;
+    unsigned long powerInterval;
+    unsigned long lastPowerAssert[GHOSTLAB42REBOOT_MAX_DISPLAYS];
+    bool powerAsserted[GHOSTLAB42REBOOT_MAX_DISPLAYS];
+
+    // How many times and how soon failed transactions are tried again, and
+    // how many attempts have failed on each display
+    byte retries;
+    unsigned int retryBackoff;
+    GhostLab42RebootErrorCounts errorCounts[GHOSTLAB42REBOOT_MAX_DISPLAYS];
+
+#if GHOSTLAB42REBOOT_STATS
+    // What has been sent to each display
+    GhostLab42RebootStats statistics[GHOSTLAB42REBOOT_MAX_DISPLAYS];
+#endif
+
+#if GHOSTLAB42REBOOT_TRACE_LENGTH > 0
+    // The most recent transactions, oldest first starting at traceHead, and
+    // how many older ones have been written over
+    TraceRecord trace[GHOSTLAB42REBOOT_TRACE_LENGTH];
+    uint16_t traceHead;
+    uint16_t traceCount;
+    unsigned long traceDropped;
+#endif
+
+#if GHOSTLAB42REBOOT_QUEUE_LENGTH > 0
+    // Transactions waiting to go out on the bus in async mode
+    bool asyncMode;
+    Transaction queue[GHOSTLAB42REBOOT_QUEUE_LENGTH];
+    byte queueHead;
+    byte queueCount;
+
+    // Failed attempts at the oldest queued transaction, when it is due to be
+    // tried again, and whether any of them hung the bus
+    byte queueAttempts;
+    unsigned long queueRetryTime;
+    bool queueBusHung;
+#endif
+
+    GhostLab42RebootCallback completionCallback;
+
+    // Whether we are between beginFrame() and endFrame(), and which displays
+    // have data waiting in their temporary registers
+    bool frameOpen;
+    bool updatePending[GHOSTLAB42REBOOT_MAX_DISPLAYS];
+
+#if GHOSTLAB42REBOOT_SCROLL_LENGTH > 0
+    // Text scrolling across each display
+    Scroll scrolls[GHOSTLAB42REBOOT_MAX_DISPLAYS];
+#endif
+
+    // Brightness fade running on each display, the brightness percentage it
+    // is at, and the last value written to its PWM Register
+    Fade fades[GHOSTLAB42REBOOT_MAX_DISPLAYS];
+    int brightnessLevels[GHOSTLAB42REBOOT_MAX_DISPLAYS];
+    byte pwmValues[GHOSTLAB42REBOOT_MAX_DISPLAYS];
+
+    // Where on() sends printed characters, shared by all of the displays
+    GhostLab42RebootPrint printSink;
 };
 
+// Handle for one of the displays in the Reboot board set
+//
+// The display ID, address, and number of digits are all known at compile
+// time, so a bad display ID does not compile, and neither does a string
+// literal that could never fit on the display (more characters than two per
+// digit, since each digit can also hold a decimal point). Only the length of
+// a literal passed to a function can be checked, so fits() counts the digits
+// of a literal exactly for static_asserts of the sketch's own. Meant for the
+// Reboot board set as set up by the plain begin()
+template <int ID>
+class GhostLab42RebootDisplay
+{
+  static_assert(ID >= 0 && ID < GHOSTLAB42REBOOT_DISPLAY_COUNT,
+                "No such display in the Reboot board set");
+
+  public:
+    static const int id = ID;
+    static const byte address = GhostLab42RebootKitBoard<ID>::address;
+    static const byte digits = GhostLab42RebootKitBoard<ID>::digits;
+
+    GhostLab42RebootDisplay(GhostLab42Reboot &reboot) : reboot(reboot) {}
+
+    // Whether a string literal fits on the display, ex.
+    // static_assert(GhostLab42RebootFour::fits("1.2.3.4."), "...")
+    template <size_t N> static constexpr bool fits(const char (&value)[N])
+    {
+      return literalDigits(value) <= digits;
+    }
+
+    // String literals and other constant character arrays
+    template <size_t N> byte write(const char (&value)[N])
+    {
+      static_assert(N - 1 <= digits * 2, "Too many characters for this display");
+      return reboot.write(ID, value, strnlen(value, N));
+    }
+
+    // Character arrays that get filled in at run time, so their contents
+    // can't be checked here
+    template <size_t N> byte write(char (&value)[N])
+    {
+      return reboot.write(ID, value, strnlen(value, N));
+    }
+
+    // Character pointers, without going through String. A template so that
+    // string literals still pick the checked overload above
+    template <typename T> byte write(T value)
+    {
+      return writePointer(value);
+    }
+
+    byte write(const char *value, size_t length)
+    {
+      return reboot.write(ID, value, length);
+    }
+
+    byte write(const __FlashStringHelper *value)
+    {
+      return reboot.write(ID, value);
+    }
+
+    byte write(const String &value)
+    {
+      return reboot.write(ID, value);
+    }
+
+    byte writeNumber(int32_t value, byte decimals = 0, char padding = ' ',
+                     GhostLab42RebootAlign align = ALIGN_RIGHT)
+    {
+      return reboot.writeNumber(ID, value, decimals, padding, align);
+    }
+
+    byte writeFixed(long mantissa, byte decimals, char padding = ' ',
+                    GhostLab42RebootAlign align = ALIGN_RIGHT)
+    {
+      return reboot.writeFixed(ID, mantissa, decimals, padding, align);
+    }
+
+    byte writeFixed(int mantissa, byte decimals, char padding = ' ',
+                    GhostLab42RebootAlign align = ALIGN_RIGHT)
+    {
+      return reboot.writeFixed(ID, mantissa, decimals, padding, align);
+    }
+
+    byte writeFixed(double value, byte decimals, char padding = ' ',
+                    GhostLab42RebootAlign align = ALIGN_RIGHT)
+    {
+      return reboot.writeFixed(ID, value, decimals, padding, align);
+    }
+
+    byte resetDisplay()
+    {
+      return reboot.resetDisplay(ID);
+    }
+
+    byte setDisplayBrightness(int brightness)
+    {
+      return reboot.setDisplayBrightness(ID, brightness);
+    }
+
+    byte fadeTo(int brightness, unsigned long duration,
+                GhostLab42RebootEasing easing = EASE_LINEAR)
+    {
+      return reboot.fadeTo(ID, brightness, duration, easing);
+    }
+  private:
+    GhostLab42Reboot &reboot;
+
+    // Digits a single character takes up, M and W need two
+    static constexpr size_t characterDigits(char character)
+    {
+      return (character == 'M' || character == 'W' ||
+              character == 'm' || character == 'w') ? 2 : 1;
+    }
+
+    // Digits a string literal takes up from index on, counted the same way
+    // GhostLab42Reboot::encodeText() encodes it: a decimal goes in the digit
+    // of the character in front of it, unless that is another decimal
+    template <size_t N> static constexpr size_t literalDigits(const char (&value)[N],
+                                                              size_t index = 0)
+    {
+      return (index >= N - 1 || value[index] == '\0') ? 0 :
+             (value[index] == '.' && (index == 0 || value[index - 1] == '.')) ?
+               1 + literalDigits(value, index + 1) :
+             (value[index + 1] == '.') ?
+               characterDigits(value[index]) + literalDigits(value, index + 2) :
+               characterDigits(value[index]) + literalDigits(value, index + 1);
+    }
+
+    // Anything other than a character pointer does not compile
+    byte writePointer(const char *value)
+    {
+      return reboot.write(ID, value);
+    }
+};
+
+// Handles for each of the displays in the Reboot board set
+typedef GhostLab42RebootDisplay<0> GhostLab42RebootSix;
+typedef GhostLab42RebootDisplay<1> GhostLab42RebootFourSmall;
+typedef GhostLab42RebootDisplay<2> GhostLab42RebootFour;
+
+// Widgets built on top of the library
+#include "GhostLab42RebootCounter.h"
+#include "GhostLab42RebootTimer.h"
+#include "GhostLab42RebootFilter.h"
+
 #endif
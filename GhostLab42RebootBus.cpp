@@ -0,0 +1,241 @@
+/*
+ * Bus backends for the GhostLab42Reboot library
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "GhostLab42RebootBus.h"
+
+/******************************************************************************
+ *                                  Wire Bus                                  *
+ ******************************************************************************/
+
+// Half of an I2C clock cycle at 100kHz, in microseconds
+const unsigned int I2C_HALF_CLOCK = 5;
+
+// Result of Wire.endTransmission() when the bus timed out
+const byte WIRE_TIMEOUT = 5;
+
+/*
+ * Parameters:
+ * wire   The Wire library instance to send the transactions through
+ * sdaPin The pin of the bus's data line, or -1 to not clear a stuck bus by
+ *        hand
+ * sclPin The pin of the bus's clock line, or -1 to not clear a stuck bus by
+ *        hand
+ */
+GhostLab42RebootWireBus::GhostLab42RebootWireBus(TwoWire &wire, int sdaPin, int sclPin)
+  : wire(wire), sdaPin(sdaPin), sclPin(sclPin) {}
+
+/*
+ * Joins the I2C bus as the master, clearing it first if a device is holding
+ * it
+ */
+void GhostLab42RebootWireBus::begin()
+{
+  if (isStuck()) recover();
+  else start();
+}
+
+/*
+ * Sends a complete transaction through the Wire library
+ *
+ * Parameters:
+ * address I2C address of the device
+ * data    The register index followed by the values for the registers
+ * length  Number of bytes in data
+ */
+byte GhostLab42RebootWireBus::transmit(byte address, const byte data[], byte length)
+{
+  wire.beginTransmission(address);
+  wire.write(data, length);
+  byte status = wire.endTransmission();
+
+#if defined(WIRE_HAS_TIMEOUT)
+  // Older versions of the Wire library report a timeout as an "other" error
+  if (wire.getWireTimeoutFlag())
+  {
+    wire.clearWireTimeoutFlag();
+    status = WIRE_TIMEOUT;
+  }
+#endif
+
+  if (status == WIRE_TIMEOUT) recover();
+  return status;
+}
+
+/*
+ * Clears a bus that a device is holding low and restarts the Wire library
+ *
+ * A device that lost track of where it was in a transaction (ex. one that
+ * was plugged in halfway through) can hold the data line low forever waiting
+ * for clock pulses. Clocking until it lets go, then sending a STOP, puts
+ * every device back to waiting for a START. Takes about 100 microseconds.
+ */
+void GhostLab42RebootWireBus::recover()
+{
+  wire.end();
+
+  if (sdaPin >= 0 && sclPin >= 0)
+  {
+    // The lines are open drain, so they are only ever driven low, and
+    // released to let the pull-ups take them high
+    // INPUT_PULLUP leaves the output value high, so it has to be set low
+    // before each switch to OUTPUT or the pin would drive the line high
+    pinMode(sdaPin, INPUT_PULLUP);
+    pinMode(sclPin, INPUT_PULLUP);
+    delayMicroseconds(I2C_HALF_CLOCK);
+
+    // A device is at most 9 clock pulses (8 bits and the acknowledge) away
+    // from letting go of the data line
+    for (byte i = 0; i < 9 && digitalRead(sdaPin) == LOW; i++)
+    {
+      digitalWrite(sclPin, LOW);
+      pinMode(sclPin, OUTPUT);
+      delayMicroseconds(I2C_HALF_CLOCK);
+      pinMode(sclPin, INPUT_PULLUP);
+      delayMicroseconds(I2C_HALF_CLOCK);
+    }
+
+    // STOP is the data line going high while the clock is high
+    digitalWrite(sclPin, LOW);
+    pinMode(sclPin, OUTPUT);
+    digitalWrite(sdaPin, LOW);
+    pinMode(sdaPin, OUTPUT);
+    delayMicroseconds(I2C_HALF_CLOCK);
+    pinMode(sclPin, INPUT_PULLUP);
+    delayMicroseconds(I2C_HALF_CLOCK);
+    pinMode(sdaPin, INPUT_PULLUP);
+    delayMicroseconds(I2C_HALF_CLOCK);
+  }
+
+  start();
+}
+
+/*
+ * Starts the Wire library with a timeout on every transaction
+ */
+void GhostLab42RebootWireBus::start()
+{
+  wire.begin();
+
+#if defined(WIRE_HAS_TIMEOUT)
+  wire.setWireTimeout(GHOSTLAB42REBOOT_WIRE_TIMEOUT, true);
+#endif
+}
+
+/*
+ * Whether a device is holding the data line low while the bus should be idle
+ */
+bool GhostLab42RebootWireBus::isStuck()
+{
+  if (sdaPin < 0 || sclPin < 0) return false;
+
+  pinMode(sdaPin, INPUT_PULLUP);
+  pinMode(sclPin, INPUT_PULLUP);
+  delayMicroseconds(I2C_HALF_CLOCK);
+  return (digitalRead(sdaPin) == LOW);
+}
+
+/******************************************************************************
+ *                               Recording Bus                                *
+ ******************************************************************************/
+
+/*
+ * Parameters:
+ * bus The bus to pass the transactions on to, or NULL to not send them
+ *     anywhere
+ */
+GhostLab42RebootRecordingBus::GhostLab42RebootRecordingBus(GhostLab42RebootBus *bus)
+  : bus(bus)
+{
+  clear();
+}
+
+/*
+ * Gets the bus that the transactions are passed on to ready
+ */
+void GhostLab42RebootRecordingBus::begin()
+{
+  if (bus != NULL) bus->begin();
+}
+
+/*
+ * Records the transaction and passes it on
+ *
+ * Parameters:
+ * address I2C address of the device
+ * data    The register index followed by the values for the registers
+ * length  Number of bytes in data
+ */
+byte GhostLab42RebootRecordingBus::transmit(byte address, const byte data[], byte length)
+{
+  byte status = 0;
+  if (bus != NULL) status = bus->transmit(address, data, length);
+
+  transactions++;
+  bytes += length;
+
+  // Keep the first transactions since the last clear(), the later ones are
+  // only counted
+  if (recorded < GHOSTLAB42REBOOT_RECORDING_LENGTH)
+  {
+    Record &record = records[recorded++];
+    record.address = address;
+    record.length = min(length, (byte)GHOSTLAB42REBOOT_MAX_TRANSACTION_LENGTH);
+    record.status = status;
+    memcpy(record.data, data, record.length);
+  }
+
+  return status;
+}
+
+/*
+ * Forgets every transaction and resets the counts
+ */
+void GhostLab42RebootRecordingBus::clear()
+{
+  transactions = 0;
+  bytes = 0;
+  recorded = 0;
+}
+
+/*
+ * Number of transactions since the last clear()
+ */
+unsigned long GhostLab42RebootRecordingBus::transactionCount()
+{
+  return transactions;
+}
+
+/*
+ * Number of bytes sent since the last clear(), counting the register index
+ * but not the address byte that starts every transaction
+ */
+unsigned long GhostLab42RebootRecordingBus::byteCount()
+{
+  return bytes;
+}
+
+/*
+ * Number of transactions that have a record (see record())
+ */
+byte GhostLab42RebootRecordingBus::recordCount()
+{
+  return recorded;
+}
+
+/*
+ * One of the first GHOSTLAB42REBOOT_RECORDING_LENGTH transactions since the
+ * last clear()
+ *
+ * Parameters:
+ * index Which transaction, 0 being the oldest. Must be less than
+ *       recordCount()
+ */
+const GhostLab42RebootRecordingBus::Record &GhostLab42RebootRecordingBus::record(byte index)
+{
+  return records[index];
+}
@@ -0,0 +1,109 @@
+/*
+ * Bus backends for the GhostLab42Reboot library
+ *
+ * The library never talks to the I2C bus directly. Every transaction goes
+ * through a GhostLab42RebootBus, so the Wire library can be swapped out for
+ * something else, or wrapped to see what the library is sending
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#ifndef GhostLab42RebootBus_h
+#define GhostLab42RebootBus_h
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "GhostLab42RebootConfig.h"
+
+// Number of "Matrix 1 Data Registers" in the IS31FL3730 (0x01 - 0x0B)
+#define GHOSTLAB42REBOOT_DATA_REGISTERS 11
+
+// Longest transaction the library sends: the register index, every data
+// register, and the Update Column Register
+#define GHOSTLAB42REBOOT_MAX_TRANSACTION_LENGTH (GHOSTLAB42REBOOT_DATA_REGISTERS + 2)
+
+// Pins the Wire library uses, so a stuck bus can be cleared by hand. -1 if
+// the board does not say, in which case the bus is only restarted
+#if defined(PIN_WIRE_SDA) && defined(PIN_WIRE_SCL)
+#define GHOSTLAB42REBOOT_SDA_PIN PIN_WIRE_SDA
+#define GHOSTLAB42REBOOT_SCL_PIN PIN_WIRE_SCL
+#else
+#define GHOSTLAB42REBOOT_SDA_PIN -1
+#define GHOSTLAB42REBOOT_SCL_PIN -1
+#endif
+
+// Something that can send I2C transactions to the displays
+class GhostLab42RebootBus
+{
+  public:
+    virtual ~GhostLab42RebootBus() {}
+
+    // Gets the bus ready, called once from GhostLab42Reboot::begin()
+    virtual void begin() = 0;
+
+    // Sends a complete transaction to the device at the address. data holds
+    // the register index followed by the values for the registers. Returns
+    // 0 on success, or the same error codes as Wire.endTransmission(). 5
+    // (timeout) means the bus hung and had to be recovered, so anything on
+    // it may have lost power
+    virtual byte transmit(byte address, const byte data[], byte length) = 0;
+};
+
+// Sends the transactions out through the Wire library (the default)
+//
+// Where the Wire library supports it, every transaction gives up after
+// GHOSTLAB42REBOOT_WIRE_TIMEOUT microseconds instead of waiting forever on a
+// bus that is being held low, and the bus is cleared and restarted
+class GhostLab42RebootWireBus : public GhostLab42RebootBus
+{
+  public:
+    GhostLab42RebootWireBus(TwoWire &wire = Wire,
+                            int sdaPin = GHOSTLAB42REBOOT_SDA_PIN,
+                            int sclPin = GHOSTLAB42REBOOT_SCL_PIN);
+    void begin();
+    byte transmit(byte address, const byte data[], byte length);
+    void recover();
+  private:
+    void start();
+    bool isStuck();
+
+    TwoWire &wire;
+    int sdaPin;
+    int sclPin;
+};
+
+// Keeps track of every transaction, and optionally passes them on to another
+// bus. Without another bus every transaction succeeds without going anywhere,
+// so the library can be run and measured without any displays attached
+class GhostLab42RebootRecordingBus : public GhostLab42RebootBus
+{
+  public:
+    // A single transaction as it was sent
+    struct Record
+    {
+      byte address;
+      byte length;
+      byte status;
+      byte data[GHOSTLAB42REBOOT_MAX_TRANSACTION_LENGTH];
+    };
+
+    GhostLab42RebootRecordingBus(GhostLab42RebootBus *bus = NULL);
+    void begin();
+    byte transmit(byte address, const byte data[], byte length);
+    void clear();
+    unsigned long transactionCount();
+    unsigned long byteCount();
+    byte recordCount();
+    const Record &record(byte index);
+  private:
+    GhostLab42RebootBus *bus;
+    unsigned long transactions;
+    unsigned long bytes;
+
+    // The first GHOSTLAB42REBOOT_RECORDING_LENGTH transactions since the
+    // last clear()
+    Record records[GHOSTLAB42REBOOT_RECORDING_LENGTH];
+    byte recorded;
+};
+
+#endif
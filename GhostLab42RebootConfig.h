@@ -0,0 +1,109 @@
+/*
+ * Compile-time settings for the GhostLab42Reboot library
+ *
+ * Arduino libraries are compiled separately from the sketch, so these have to
+ * be changed here rather than with a #define in the sketch
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#ifndef GhostLab42RebootConfig_h
+#define GhostLab42RebootConfig_h
+
+// Number of IS31FL3730 boards the library can drive. The Reboot board set
+// has 3, and a single I2C bus has room for 4 (0x60 - 0x63). Every display
+// takes up around 100 bytes of RAM, most of it for scrolling text. Can't be
+// more than 16
+#ifndef GHOSTLAB42REBOOT_MAX_DISPLAYS
+#define GHOSTLAB42REBOOT_MAX_DISPLAYS 4
+#endif
+
+// The displays that are present and need replaying are kept as bits in a
+// uint16_t
+static_assert(GHOSTLAB42REBOOT_MAX_DISPLAYS <= 16,
+              "GHOSTLAB42REBOOT_MAX_DISPLAYS can't be more than 16");
+
+// Milliseconds between checks for whether displays that stopped answering
+// have been plugged back in, made by update() or the next write to one
+#ifndef GHOSTLAB42REBOOT_PROBE_INTERVAL
+#define GHOSTLAB42REBOOT_PROBE_INTERVAL 1000
+#endif
+
+// Number of transactions that can be waiting to go out on the bus in async
+// mode. Each one takes up GHOSTLAB42REBOOT_MAX_TRANSACTION_LENGTH + 2 bytes
+// of RAM. 0 leaves async mode out and compiles none of it in
+#ifndef GHOSTLAB42REBOOT_QUEUE_LENGTH
+#define GHOSTLAB42REBOOT_QUEUE_LENGTH 8
+#endif
+
+// Number of digits that text scrolling across a display can take up once it
+// is encoded (decimals do not take up a digit of their own). Each display
+// gets its own buffer of this size. 0 leaves scrolling out and compiles none
+// of it in, saving the buffers for sketches that never scroll. Can't be more
+// than 255
+#ifndef GHOSTLAB42REBOOT_SCROLL_LENGTH
+#define GHOSTLAB42REBOOT_SCROLL_LENGTH 48
+#endif
+
+static_assert(GHOSTLAB42REBOOT_SCROLL_LENGTH <= 255,
+              "GHOSTLAB42REBOOT_SCROLL_LENGTH can't be more than 255");
+
+// Number of transactions a GhostLab42RebootRecordingBus keeps a copy of.
+// Only takes up RAM if the sketch creates a recording bus
+#ifndef GHOSTLAB42REBOOT_RECORDING_LENGTH
+#define GHOSTLAB42REBOOT_RECORDING_LENGTH 16
+#endif
+
+// Number of times a failed transaction is tried again, and the microseconds
+// to wait before the first retry (doubling for each one after that). Can be
+// changed at runtime with setRetryPolicy()
+#ifndef GHOSTLAB42REBOOT_RETRIES
+#define GHOSTLAB42REBOOT_RETRIES 2
+#endif
+
+#ifndef GHOSTLAB42REBOOT_RETRY_BACKOFF
+#define GHOSTLAB42REBOOT_RETRY_BACKOFF 100
+#endif
+
+// Microseconds a single transaction can take before the Wire library gives
+// up on a bus that is being held low and the bus is cleared and restarted.
+// Only used by versions of the Wire library that support timeouts
+#ifndef GHOSTLAB42REBOOT_WIRE_TIMEOUT
+#define GHOSTLAB42REBOOT_WIRE_TIMEOUT 25000
+#endif
+
+// Set to 1 to keep count of what is sent to each display and how long the
+// functions take, see stats(). Takes up around 50 bytes of RAM per display
+// and a call to micros() at the start and end of every write, so it is off
+// by default, and none of it is compiled in while it is off
+#ifndef GHOSTLAB42REBOOT_STATS
+#define GHOSTLAB42REBOOT_STATS 0
+#endif
+
+// Number of transactions kept in the trace, see dumpTrace(). Each one takes
+// up 8 bytes of RAM. 0 turns the trace off and compiles none of it in
+#ifndef GHOSTLAB42REBOOT_TRACE_LENGTH
+#define GHOSTLAB42REBOOT_TRACE_LENGTH 0
+#endif
+
+// Hooks that run around every transaction and around every public function
+// that can talk to the displays, ex. to set a pin with a direct port write
+// and time them with a logic analyzer (see general.md). They do nothing by
+// default, and compile to nothing
+#ifndef GHOSTLAB42REBOOT_TRANSACTION_BEGIN
+#define GHOSTLAB42REBOOT_TRANSACTION_BEGIN(address)
+#endif
+
+#ifndef GHOSTLAB42REBOOT_TRANSACTION_END
+#define GHOSTLAB42REBOOT_TRANSACTION_END(address, status)
+#endif
+
+#ifndef GHOSTLAB42REBOOT_API_BEGIN
+#define GHOSTLAB42REBOOT_API_BEGIN()
+#endif
+
+#ifndef GHOSTLAB42REBOOT_API_END
+#define GHOSTLAB42REBOOT_API_END()
+#endif
+
+#endif
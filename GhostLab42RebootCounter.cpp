@@ -0,0 +1,163 @@
+/*
+ * Counter widget for the GhostLab42Reboot library
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include <Arduino.h>
+#include "GhostLab42RebootCounter.h"
+
+/*
+ * Parameters:
+ * reboot    The library instance that the display belongs to
+ * displayID Unique identifier for the display to count on
+ * padding   Character shown in front of the count, '0' for a full row of
+ *           digits like an odometer
+ */
+GhostLab42RebootCounter::GhostLab42RebootCounter(GhostLab42Reboot &reboot, int displayID,
+                                                 char padding)
+  : reboot(reboot), displayID(displayID), padding(padding), significantDigits(0)
+{
+  memset(digits, 0, sizeof(digits));
+  memset(segments, 0, sizeof(segments));
+}
+
+/*
+ * Sets the count and shows it
+ *
+ * Anything that does not fit on the display is dropped from the front, the
+ * same as an odometer rolling over
+ *
+ * Parameters:
+ * value The new count
+ *
+ * Returns the result of sending the digits that changed
+ */
+byte GhostLab42RebootCounter::set(uint32_t value)
+{
+  byte width = reboot.getDisplayDigits(displayID);
+  for (byte i = 0; i < width; i++)
+  {
+    digits[i] = value % 10;
+    value /= 10;
+  }
+
+  return show(width);
+}
+
+/*
+ * Counts up and shows the digits that changed
+ *
+ * Parameters:
+ * steps How far to count
+ *
+ * Returns the result of sending the digits that changed
+ */
+byte GhostLab42RebootCounter::increment(uint32_t steps)
+{
+  return add(steps, false);
+}
+
+/*
+ * Counts down and shows the digits that changed
+ *
+ * Counting down past 0 rolls over to all 9s
+ *
+ * Parameters:
+ * steps How far to count
+ *
+ * Returns the result of sending the digits that changed
+ */
+byte GhostLab42RebootCounter::decrement(uint32_t steps)
+{
+  return add(steps, true);
+}
+
+/*
+ * Gets the count that is on the display
+ */
+uint32_t GhostLab42RebootCounter::getValue()
+{
+  uint32_t value = 0;
+  for (byte i = reboot.getDisplayDigits(displayID); i > 0; i--)
+  {
+    value = value * 10 + digits[i - 1];
+  }
+
+  return value;
+}
+
+/*
+ * Adds or subtracts one digit at a time, carrying into the next digit only
+ * when needed
+ *
+ * Parameters:
+ * steps    How far to count
+ * subtract Whether to count down instead of up
+ *
+ * Returns the result of sending the digits that changed
+ */
+byte GhostLab42RebootCounter::add(uint32_t steps, bool subtract)
+{
+  // Stop as soon as there is nothing left to carry, which for a single step
+  // is almost always the first digit
+  byte width = reboot.getDisplayDigits(displayID);
+  byte carry = 0;
+  byte i = 0;
+  for (; i < width && (steps > 0 || carry > 0); i++)
+  {
+    byte step = steps % 10 + carry;
+    steps /= 10;
+
+    if (subtract)
+    {
+      carry = (digits[i] < step) ? 1 : 0;
+      digits[i] = digits[i] + 10 * carry - step;
+    }
+    else
+    {
+      byte sum = digits[i] + step;
+      carry = (sum >= 10) ? 1 : 0;
+      digits[i] = sum - 10 * carry;
+    }
+  }
+
+  return show(i);
+}
+
+/*
+ * Encodes the digits that changed and sends them
+ *
+ * Parameters:
+ * changedDigits Number of digits that changed, counting from the least
+ *               significant one
+ */
+byte GhostLab42RebootCounter::show(byte changedDigits)
+{
+  byte width = reboot.getDisplayDigits(displayID);
+
+  // The padding in front of the count moves when it gains or loses a digit,
+  // and the first time nothing is on the display yet
+  byte significant = width;
+  while (significant > 1 && digits[significant - 1] == 0) significant--;
+  if (significantDigits == 0)
+  {
+    changedDigits = width;
+  }
+  else if (padding != '0' && significant != significantDigits)
+  {
+    changedDigits = max(changedDigits, max(significant, significantDigits));
+  }
+  significantDigits = significant;
+
+  char characters[2] = {0, 0};
+  byte glyphs[2];
+  for (byte i = 0; i < changedDigits && i < width; i++)
+  {
+    characters[0] = (i < significant || padding == '0') ? '0' + digits[i] : padding;
+    reboot.encodeCharacter(characters, glyphs);
+    segments[width - 1 - i] = glyphs[0];
+  }
+
+  return reboot.writeSegments(displayID, segments, width);
+}
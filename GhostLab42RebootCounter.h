@@ -0,0 +1,41 @@
+/*
+ * Counter widget for the GhostLab42Reboot library
+ *
+ * Counts like an odometer on a single display, keeping one decimal digit per
+ * display digit so a step only has to touch the digits it carries into
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#ifndef GhostLab42RebootCounter_h
+#define GhostLab42RebootCounter_h
+
+#include <Arduino.h>
+#include "GhostLab42Reboot.h"
+
+class GhostLab42RebootCounter
+{
+  public:
+    GhostLab42RebootCounter(GhostLab42Reboot &reboot, int displayID, char padding = '0');
+    byte set(uint32_t value);
+    byte increment(uint32_t steps = 1);
+    byte decrement(uint32_t steps = 1);
+    uint32_t getValue();
+  private:
+    byte add(uint32_t steps, bool subtract);
+    byte show(byte changedDigits);
+
+    GhostLab42Reboot &reboot;
+    int displayID;
+    char padding;
+
+    // Decimal digits of the count, least significant first, and how many of
+    // them are shown in front of the padding (0 until the first time)
+    byte digits[GHOSTLAB42REBOOT_DATA_REGISTERS];
+    byte significantDigits;
+
+    // What the display should show, leftmost digit first
+    byte segments[GHOSTLAB42REBOOT_DATA_REGISTERS];
+};
+
+#endif
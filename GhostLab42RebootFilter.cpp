@@ -0,0 +1,123 @@
+/*
+ * Filtered number widget for the GhostLab42Reboot library
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include <Arduino.h>
+#include "GhostLab42RebootFilter.h"
+
+// Bits after the binary point in the running average
+const byte AVERAGE_FRACTION_BITS = 8;
+
+// Most smoothing the filter does. Each reading only moves the average by
+// 1/65536 of the way towards it at this point, and anything past it would
+// shift the divisor out of range
+const byte MAX_SMOOTHING = 16;
+
+/*
+ * Parameters:
+ * reboot    The library instance that the display belongs to
+ * displayID Unique identifier for the display to show the reading on
+ * deadband  How far a reading has to move away from what is on the display
+ *           before the display changes, in the same units as the reading
+ * holdTime  Least time in milliseconds that a value stays on the display
+ * smoothing Running average over roughly 2^smoothing readings, 0 for none,
+ *           up to 16
+ */
+GhostLab42RebootFilter::GhostLab42RebootFilter(GhostLab42Reboot &reboot, int displayID,
+                                               int32_t deadband, unsigned long holdTime,
+                                               byte smoothing)
+  : reboot(reboot), displayID(displayID), deadband(deadband), holdTime(holdTime),
+    smoothing(min(smoothing, MAX_SMOOTHING)), average(0), shownValue(0), shownDecimals(0), shownTime(0),
+    shown(false), suppressedWrites(0) {}
+
+/*
+ * Takes a new reading and writes it to the display with writeNumber() if
+ * what the display shows should change
+ *
+ * The display changes once the (smoothed) reading is more than the deadband
+ * away from what the display shows and the hold time has passed since it
+ * last changed. Every other reading is suppressed without touching the bus.
+ *
+ * Parameters:
+ * value     The reading, as a fixed-point number like writeNumber() takes
+ * decimals  Number of digits after the decimal point
+ * padding   Character used to fill the unused digits in front of a right
+ *           aligned number, ex. '0' for leading zeros
+ * align     Whether the number sits against the left or right of the display
+ *
+ * Returns GHOSTLAB42REBOOT_OK if the reading was suppressed, otherwise the
+ * result of writeNumber()
+ */
+byte GhostLab42RebootFilter::write(int32_t value, byte decimals, char padding,
+                                   GhostLab42RebootAlign align)
+{
+  // Verify the display exists before keeping count of anything for it
+  if (reboot.getDisplayDigits(displayID) == 0) return GHOSTLAB42REBOOT_ERROR_INVALID_DISPLAY;
+
+  // Exponential moving average in fixed point: each reading moves the
+  // average 1/2^smoothing of the way towards it. The first reading starts
+  // the average off so it does not have to climb up from 0
+  int32_t filtered = value;
+  if (smoothing > 0)
+  {
+    int64_t scaled = (int64_t)value * (1L << AVERAGE_FRACTION_BITS);
+    if (shown == false) average = scaled;
+    average += (scaled - average) / (1L << smoothing);
+
+    // Round to the nearest whole reading, which is always between the
+    // readings so far and so fits back in an int32_t
+    int32_t half = 1L << (AVERAGE_FRACTION_BITS - 1);
+    filtered = (average + ((average < 0) ? -half : half)) / (1L << AVERAGE_FRACTION_BITS);
+  }
+
+  // The digits on the display only change if the value or the decimal point
+  // does
+  if (shown && decimals == shownDecimals)
+  {
+    int32_t change = filtered - shownValue;
+    if (change < 0) change = -change;
+
+    if (change <= deadband || millis() - shownTime < holdTime)
+    {
+      suppressedWrites++;
+#if GHOSTLAB42REBOOT_STATS
+      reboot.statistics[displayID].suppressedWrites++;
+#endif
+      return GHOSTLAB42REBOOT_OK;
+    }
+  }
+
+  shownValue = filtered;
+  shownDecimals = decimals;
+  shownTime = millis();
+  shown = true;
+
+  return reboot.writeNumber(displayID, filtered, decimals, padding, align);
+}
+
+/*
+ * Forgets the running average and what is on the display, so the next
+ * reading is written no matter what
+ */
+void GhostLab42RebootFilter::reset()
+{
+  shown = false;
+}
+
+/*
+ * Gets the value that was last written to the display
+ */
+int32_t GhostLab42RebootFilter::getValue()
+{
+  return shownValue;
+}
+
+/*
+ * Gets the number of readings that did not change the display
+ */
+unsigned long GhostLab42RebootFilter::getSuppressedCount()
+{
+  return suppressedWrites;
+}
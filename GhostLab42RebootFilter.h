@@ -0,0 +1,48 @@
+/*
+ * Filtered number widget for the GhostLab42Reboot library
+ *
+ * Shows a noisy reading (ex. from a sensor) without redrawing the display
+ * every time it jitters, by smoothing it, ignoring small changes, and
+ * holding each value on the display for a minimum time
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#ifndef GhostLab42RebootFilter_h
+#define GhostLab42RebootFilter_h
+
+#include <Arduino.h>
+#include "GhostLab42Reboot.h"
+
+class GhostLab42RebootFilter
+{
+  public:
+    GhostLab42RebootFilter(GhostLab42Reboot &reboot, int displayID, int32_t deadband = 0,
+                           unsigned long holdTime = 0, byte smoothing = 0);
+    byte write(int32_t value, byte decimals = 0, char padding = ' ',
+               GhostLab42RebootAlign align = ALIGN_RIGHT);
+    void reset();
+    int32_t getValue();
+    unsigned long getSuppressedCount();
+  private:
+    GhostLab42Reboot &reboot;
+    int displayID;
+    int32_t deadband;
+    unsigned long holdTime;
+    byte smoothing;
+
+    // Running average of the readings, with 8 bits after the binary point
+    // Every int32_t reading fits once it is shifted over
+    int64_t average;
+
+    // What is on the display, with the decimals it was written with, and when
+    // it was written
+    int32_t shownValue;
+    byte shownDecimals;
+    unsigned long shownTime;
+    bool shown;
+
+    unsigned long suppressedWrites;
+};
+
+#endif
@@ -0,0 +1,203 @@
+/*
+ * Clock, stopwatch, and countdown widget for the GhostLab42Reboot library
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include <Arduino.h>
+#include "GhostLab42RebootTimer.h"
+
+// Seconds in a day, for the clock to roll over at
+const uint32_t SECONDS_PER_DAY = 86400;
+
+// Longest time the hours have room for, 99.59.59, for the stopwatch to stop
+// at and the countdown to start from
+const uint32_t MAX_SECONDS = 100UL * 3600 - 1;
+
+/*
+ * Parameters:
+ * reboot    The library instance that the display belongs to
+ * displayID Unique identifier for the display to show the time on
+ * mode      Whether to show the time of day, count up, or count down
+ */
+GhostLab42RebootTimer::GhostLab42RebootTimer(GhostLab42Reboot &reboot, int displayID,
+                                             GhostLab42RebootTimerMode mode)
+  : reboot(reboot), displayID(displayID), mode(mode), seconds(0), nextTick(1000),
+    running(false) {}
+
+/*
+ * Starts the timer from the given time and shows it
+ *
+ * Parameters:
+ * seconds The time to start from: the time of day in seconds since
+ *         midnight for a clock, or the seconds to count down from, up to
+ *         99 hours 59 minutes and 59 seconds
+ *
+ * Returns the result of sending the time
+ */
+byte GhostLab42RebootTimer::start(uint32_t seconds)
+{
+  if (mode == TIMER_CLOCK) seconds %= SECONDS_PER_DAY;
+  else if (seconds > MAX_SECONDS) seconds = MAX_SECONDS;
+
+  this->seconds = seconds;
+  nextTick = millis() + 1000;
+  running = (mode == TIMER_CLOCK) ||
+            (mode == TIMER_STOPWATCH && seconds < MAX_SECONDS) ||
+            (mode == TIMER_COUNTDOWN && seconds > 0);
+
+  return show();
+}
+
+/*
+ * Stops the timer, keeping the time on the display
+ */
+void GhostLab42RebootTimer::stop()
+{
+  if (running == false) return;
+
+  // Keep the part of the second that had already passed for resume()
+  nextTick = nextTick - millis();
+  running = false;
+}
+
+/*
+ * Carries on from where stop() left off
+ *
+ * Returns the result of sending the time
+ */
+byte GhostLab42RebootTimer::resume()
+{
+  if (running || isExpired()) return GHOSTLAB42REBOOT_OK;
+  if (mode == TIMER_STOPWATCH && seconds >= MAX_SECONDS) return GHOSTLAB42REBOOT_OK;
+
+  nextTick = millis() + nextTick;
+  running = true;
+
+  return update();
+}
+
+/*
+ * Moves the time along and shows it once a second. This should be called
+ * from loop() at least a few times a second.
+ *
+ * Every tick is scheduled exactly one second after the one before it, not
+ * one second after update() noticed it, so a late update() never pushes the
+ * rest of the ticks back. If update() was not called for several seconds,
+ * the time catches up all at once.
+ *
+ * Returns the result of sending the time, or GHOSTLAB42REBOOT_OK if it was
+ * not time to tick yet
+ */
+byte GhostLab42RebootTimer::update()
+{
+  if (running == false) return GHOSTLAB42REBOOT_OK;
+
+  // Signed, so the comparison still works when millis() rolls over
+  unsigned long now = millis();
+  if ((long)(now - nextTick) < 0) return GHOSTLAB42REBOOT_OK;
+
+  while ((long)(now - nextTick) >= 0)
+  {
+    nextTick += 1000;
+
+    if (mode == TIMER_COUNTDOWN)
+    {
+      seconds--;
+      if (seconds == 0)
+      {
+        running = false;
+        break;
+      }
+    }
+    else if (mode == TIMER_CLOCK)
+    {
+      seconds++;
+      if (seconds == SECONDS_PER_DAY) seconds = 0;
+    }
+    else
+    {
+      // Past 99 hours the hours would no longer fit, so stop there
+      seconds++;
+      if (seconds >= MAX_SECONDS)
+      {
+        seconds = MAX_SECONDS;
+        running = false;
+        break;
+      }
+    }
+  }
+
+  return show();
+}
+
+/*
+ * Gets the time on the display in seconds
+ */
+uint32_t GhostLab42RebootTimer::getSeconds()
+{
+  return seconds;
+}
+
+/*
+ * Whether the timer is moving
+ */
+bool GhostLab42RebootTimer::isRunning()
+{
+  return running;
+}
+
+/*
+ * Whether a countdown has reached 0
+ */
+bool GhostLab42RebootTimer::isExpired()
+{
+  return mode == TIMER_COUNTDOWN && seconds == 0;
+}
+
+/*
+ * Shows the time, with decimal points between the hours, minutes, and
+ * seconds
+ *
+ * The six-digit display shows HH.MM.SS. The four-digit displays show MM.SS,
+ * or HH.MM for a clock and for anything of 100 minutes or more.
+ */
+byte GhostLab42RebootTimer::show()
+{
+  byte width = reboot.getDisplayDigits(displayID);
+  if (width == 0) return GHOSTLAB42REBOOT_ERROR_INVALID_DISPLAY;
+  if (width < 4) return GHOSTLAB42REBOOT_ERROR_OVERFLOW;
+
+  uint32_t minutes = seconds / 60;
+  byte fields[3] = {(byte)((minutes / 60) % 100), (byte)(minutes % 60), (byte)(seconds % 60)};
+  byte firstField = 0;
+  if (width < 6)
+  {
+    firstField = (mode == TIMER_CLOCK || minutes >= 100) ? 0 : 1;
+    if (firstField == 1 && minutes >= 60) fields[1] = minutes;
+  }
+  byte fieldCount = (width < 6) ? 2 : 3;
+
+  // Two digits per field, right aligned, with the decimal point on the last
+  // digit of every field but the last
+  byte segments[GHOSTLAB42REBOOT_DATA_REGISTERS];
+  memset(segments, 0x00, sizeof(segments));
+  char characters[2] = {0, 0};
+  byte glyphs[2];
+  byte position = width - fieldCount * 2;
+  for (byte i = 0; i < fieldCount; i++)
+  {
+    byte field = fields[firstField + i];
+    characters[0] = '0' + field / 10;
+    reboot.encodeCharacter(characters, glyphs);
+    segments[position++] = glyphs[0];
+
+    characters[0] = '0' + field % 10;
+    characters[1] = (i < fieldCount - 1) ? '.' : 0;
+    reboot.encodeCharacter(characters, glyphs);
+    segments[position++] = glyphs[0];
+    characters[1] = 0;
+  }
+
+  return reboot.writeSegments(displayID, segments, width);
+}
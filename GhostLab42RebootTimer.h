@@ -0,0 +1,51 @@
+/*
+ * Clock, stopwatch, and countdown widget for the GhostLab42Reboot library
+ *
+ * Ticks once a second from absolute millis() deadlines, so the time never
+ * drifts no matter how long loop() takes, and only sends the display from the
+ * first digit that changed on each tick
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#ifndef GhostLab42RebootTimer_h
+#define GhostLab42RebootTimer_h
+
+#include <Arduino.h>
+#include "GhostLab42Reboot.h"
+
+// What a timer counts
+enum GhostLab42RebootTimerMode
+{
+  TIMER_CLOCK,     // Time of day, rolls over after 23:59:59
+  TIMER_STOPWATCH, // Counts up from the start
+  TIMER_COUNTDOWN  // Counts down to 0 and stops there
+};
+
+class GhostLab42RebootTimer
+{
+  public:
+    GhostLab42RebootTimer(GhostLab42Reboot &reboot, int displayID,
+                          GhostLab42RebootTimerMode mode);
+    byte start(uint32_t seconds = 0);
+    void stop();
+    byte resume();
+    byte update();
+    uint32_t getSeconds();
+    bool isRunning();
+    bool isExpired();
+  private:
+    byte show();
+
+    GhostLab42Reboot &reboot;
+    int displayID;
+    GhostLab42RebootTimerMode mode;
+
+    // Seconds on the display, and the millis() of the next tick while
+    // running, or how long the next tick was away when it was stopped
+    uint32_t seconds;
+    unsigned long nextTick;
+    bool running;
+};
+
+#endif
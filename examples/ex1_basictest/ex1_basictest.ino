@@ -14,13 +14,19 @@ void setup()
 void loop()
 {
   // Write specific numbers to all the displays in a flashing pattern
+  // Wrapping the writes in a frame makes all three displays change at the
+  // same time
+  reboot.beginFrame();
   reboot.write(0, "9146431");
   reboot.write(1, "1923");
   reboot.write(2, "5678");
+  reboot.endFrame();
   delay(200);
 
+  reboot.beginFrame();
   reboot.write(0, "1709752");
   reboot.write(1, "8210");
   reboot.write(2, "4251");
+  reboot.endFrame();
   delay(200);
 }
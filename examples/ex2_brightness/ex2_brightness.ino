@@ -3,6 +3,9 @@
 
 GhostLab42Reboot reboot;
 
+// Whether the displays are currently fading up or down
+bool fadingUp = false;
+
 void setup() 
 {
   reboot.begin();
@@ -10,7 +13,7 @@ void setup()
   // Set the initial display brightness
   reboot.setDisplayBrightness(0, 0);
   reboot.setDisplayBrightness(1, 0);
-  reboot.setDisplayBrightness(2, 0);
+  reboot.setDisplayBrightness(2, 100);
 
   // Write values to the displays
   reboot.write(0, "8.8.8.8.8.8.");
@@ -20,27 +23,17 @@ void setup()
 
 void loop()
 {
-  // Loop over the 100 different display brightness settings
-  for (int i = 0; i <= 100; i++)
-  {
-    // Set the display brightness
-    reboot.setDisplayBrightness(0, i);
-    reboot.setDisplayBrightness(1, i/2);
-    reboot.setDisplayBrightness(2, 100-i);
-    
-    // Wait for 20ms then use the next brightness setting
-    delay(20);
-  }
+  // Keep the fades going
+  reboot.update();
 
-  // Loop over the 100 different display brightness settings
-  for (int i = 0; i <= 100; i++)
+  // Once the displays are done fading, turn around and fade the other way
+  // over the next two seconds
+  if (!reboot.isFading(0))
   {
-    // Set the display brightness
-    reboot.setDisplayBrightness(0, 100 - i);
-    reboot.setDisplayBrightness(1, 50 + i/2);
-    reboot.setDisplayBrightness(2, i);
-    
-    // Wait for 20ms then use the next brightness setting
-    delay(20);
+    fadingUp = !fadingUp;
+
+    reboot.fadeTo(0, fadingUp ? 100 : 0, 2000);
+    reboot.fadeTo(1, fadingUp ? 50 : 0, 2000, EASE_IN_OUT);
+    reboot.fadeTo(2, fadingUp ? 0 : 100, 2000);
   }
 }
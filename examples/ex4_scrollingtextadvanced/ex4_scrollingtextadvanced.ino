@@ -3,67 +3,43 @@
 
 GhostLab42Reboot reboot;
 
+// Time that the display was last switched between scrolling and counting
+unsigned long lastSwitch = 0;
+
 void setup()
 {
   reboot.begin();
   reboot.write(1, "126.2");
   reboot.write(2, "-46.9");
+
+  // Scroll text with periods/decimals across the six digit display
+  // A NOTE ABOUT SCROLLING:
+  // A period/decimal is wrapped into the previous character's digit, so it
+  // scrolls along with that character instead of taking up a digit of its own.
+  // A period/decimal that is the first character or follows another
+  // period/decimal does get a digit of its own.
+  // F() keeps the text in flash instead of using up RAM
+  reboot.scroll(0, F("       . Test 1.2.3.4.  ...      "), 250);
 }
 
 void loop()
 {
-  // String to be scrolled across the six digit display
-  // Need the extra spaces to make the scrolling smooth
-  String displayText = "       . Test 1.2.3.4.  ...      ";
+  // Keep the text moving
+  reboot.update();
 
-  // A NOTE ABOUT SCROLLING:
-  // This more complicated method of scrolling handles periods/decimals, which are
-  // more complicated than other characters. A period/decimal is either considered 
-  // part of the previous character or its own character if it is in the first
-  // position of the display (in which case there is technically a "space" in
-  // front of it).
-  // Check out ex3_scrollingtext instead if you are not planning on scrolling a
-  // string with a period/decimal
-
-  // Commence scrolling
-  for (int i = 0; i < displayText.length(); i++)
+  // Every 10 seconds, switch between scrolling and showing a number
+  if (millis() - lastSwitch >= 10000)
   {
-    // Offset helps manage the number of characters we're sending to the display
-    // offset = number of digits on the display + 1
-    int offset = 7;
+    lastSwitch = millis();
 
-    // Loop over the first six characters of this iteration
-    for (int j = 0; j < offset; j++)
+    if (reboot.isScrolling(0))
     {
-      // If the string has a period, don't count it as a separate character
-      if (displayText.charAt(i+j) == '.')
-      {
-        offset += 1;
-      }
-    }
-
-    // If the first character in the string is a period/decimal and the
-    // previous character was not a period/decimal, the previous character
-    // was cut off during the scrolling
-    // Just let the period/decimal disappear since we do not want it to
-    // scroll off the display like a regular character.
-    if (displayText.charAt(i) == '.' && displayText.charAt(i - 1) != '.')
-    {
-      // Write the string to the display with the extra offset
-      reboot.write(0, displayText.substring(i + 1, i + offset + 1));
+      reboot.stopScroll(0);
+      reboot.writeNumber(0, 12345, 2);
     }
     else
     {
-      // Write the string to the display with the normal offset
-      reboot.write(0, displayText.substring(i, i + offset));
-
-      // Essentially the refresh rate of the display
-      // No need to use the delay in the previous case
-      delay(250);
+      reboot.scroll(0, F("       . Test 1.2.3.4.  ...      "), 250);
     }
-
   }
-
-  // Clear the display and start over
-  reboot.resetDisplay(0);
 }
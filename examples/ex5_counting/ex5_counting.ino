@@ -3,6 +3,14 @@
 
 GhostLab42Reboot reboot;
 
+// Counters only redo the digits that change on each step
+GhostLab42RebootCounter countdown(reboot, 0, ' ');
+GhostLab42RebootCounter countup(reboot, 1, '0');
+
+// Ignores jitter of 1 count, and keeps each value up for at least half a
+// second
+GhostLab42RebootFilter reading(reboot, 2, 1, 500);
+
 void setup()
 {
   reboot.begin();
@@ -15,26 +23,20 @@ void setup()
 
 void loop()
 {
-  String countStr;
-  int count = 2087;
+  countdown.set(120999L);
+  countup.set(0);
   
   for (int i = 0; i < 1000; i++)
   {
     // Count down
-    reboot.write(0, String(120999 - i));
+    countdown.decrement();
 
     // Count up with leading 0s really fast
-    countStr = "000" + String(16 * i);
-    reboot.write(1, countStr.substring(countStr.length() - 4));
+    countup.increment(16);
     
     // Show a number that is about 2087 but moves around randomly by a few counts
-    // Slow the update down so it changes more slowly
-    if ((i % 30) == 0)
-    {
-      count = 2087 + random(-2, 3);
-    }
-    
-    reboot.write(2, String(count));
+    // The filter keeps the display from flickering between the readings
+    reading.write(2087 + random(-2, 3));
 
     delay(30);  
   }
@@ -0,0 +1,186 @@
+#include <GhostLab42Reboot.h>
+#include <Wire.h>
+
+// Measures what each of the library functions costs, using scenarios modeled
+// on the other examples. Nothing is sent to the displays: the recording bus
+// counts the transactions and bytes instead, so this runs without any
+// displays attached and only the time spent inside the library is measured.
+// The results are printed over Serial as CSV so they can be compared between
+// versions of the library.
+
+// Simulated bus that every transaction goes to
+GhostLab42RebootRecordingBus recordingBus;
+GhostLab42Reboot reboot(recordingBus);
+
+// Number of times each scenario runs
+const int iterations = 200;
+
+// I2C clock speeds to model the time on the wire for
+const unsigned long clockSpeeds[] = {100000, 400000, 1000000};
+
+// Time that the current scenario started
+unsigned long scenarioStart;
+
+void setup()
+{
+  Serial.begin(115200);
+  reboot.begin();
+
+  Serial.println(F("scenario,calls,ns_per_call,transactions_per_call,bytes_per_call,"
+                   "wire_us_per_call_100khz,wire_us_per_call_400khz,wire_us_per_call_1mhz"));
+
+  // ex1: Flash numbers on all three displays
+  startScenario();
+  for (int i = 0; i < iterations; i++)
+  {
+    reboot.write(0, (i % 2) ? "9146431" : "1709752");
+    reboot.write(1, (i % 2) ? "1923" : "8210");
+    reboot.write(2, (i % 2) ? "5678" : "4251");
+  }
+  endScenario(F("flashing_digits"), iterations * 3L);
+
+  // ex1 again, with all three displays updating at the same time
+  startScenario();
+  for (int i = 0; i < iterations; i++)
+  {
+    reboot.beginFrame();
+    reboot.write(0, (i % 2) ? "9146431" : "1709752");
+    reboot.write(1, (i % 2) ? "1923" : "8210");
+    reboot.write(2, (i % 2) ? "5678" : "4251");
+    reboot.endFrame();
+  }
+  endScenario(F("flashing_digits_frame"), iterations * 3L);
+
+  // ex2: Ramp the brightness of all three displays
+  startScenario();
+  for (int i = 0; i < iterations; i++)
+  {
+    reboot.setDisplayBrightness(0, i % 101);
+    reboot.setDisplayBrightness(1, (i % 101) / 2);
+    reboot.setDisplayBrightness(2, 100 - i % 101);
+  }
+  endScenario(F("brightness"), iterations * 3L);
+
+  // ex3: Scroll text across the six digit display, one step per update()
+  reboot.scroll(0, "      Who ya gonna call?     Ghostbusters!      ", 0);
+  startScenario();
+  for (int i = 0; i < iterations; i++)
+  {
+    reboot.update();
+  }
+  endScenario(F("scrolling"), iterations);
+  reboot.stopScroll(0);
+
+  // ex5: Count on all three displays
+  startScenario();
+  for (int i = 0; i < iterations; i++)
+  {
+    reboot.writeNumber(0, 120999L - i);
+    reboot.writeNumber(1, (16 * i) % 10000, 0, '0');
+    reboot.writeNumber(2, 2087 + (i % 5) - 2);
+  }
+  endScenario(F("counting"), iterations * 3L);
+
+  // ex5 with counters, which only re-encode the digits that changed
+  GhostLab42RebootCounter countdown(reboot, 0, ' ');
+  GhostLab42RebootCounter countup(reboot, 1, '0');
+  countdown.set(120999L);
+  countup.set(0);
+  startScenario();
+  for (int i = 0; i < iterations; i++)
+  {
+    countdown.decrement();
+    countup.increment(16);
+  }
+  endScenario(F("counting_counter"), iterations * 2L);
+
+  // ex5's jittery reading, filtered so most readings never reach the bus
+  GhostLab42RebootFilter reading(reboot, 2, 1, 500);
+  startScenario();
+  for (int i = 0; i < iterations; i++)
+  {
+    reading.write(2087 + (i % 5) - 2);
+  }
+  endScenario(F("jitter_filter"), iterations);
+
+  // ex5 the way it used to be done, building a String for every write
+  startScenario();
+  for (int i = 0; i < iterations; i++)
+  {
+    reboot.write(0, String(120999L - i));
+  }
+  endScenario(F("counting_string"), iterations);
+
+  // ex3: Sensor readings with a decimal point
+  startScenario();
+  for (int i = 0; i < iterations; i++)
+  {
+    reboot.writeFixed(1, 126.2 + i * 0.1, 1);
+    reboot.writeFixed(2, -42.9 - i * 0.1, 1);
+  }
+  endScenario(F("sensor_fixed"), iterations * 2L);
+
+  // The same readings formatted by String
+  startScenario();
+  for (int i = 0; i < iterations; i++)
+  {
+    reboot.write(1, String(126.2 + i * 0.1, 1));
+    reboot.write(2, String(-42.9 - i * 0.1, 1));
+  }
+  endScenario(F("sensor_string"), iterations * 2L);
+
+  // Clear the display
+  startScenario();
+  for (int i = 0; i < iterations; i++)
+  {
+    reboot.resetDisplay(i % 3);
+  }
+  endScenario(F("reset"), iterations);
+}
+
+void loop()
+{
+}
+
+/*
+ * Starts measuring a scenario
+ */
+void startScenario()
+{
+  recordingBus.clear();
+  scenarioStart = micros();
+}
+
+/*
+ * Stops measuring a scenario and prints a line of results for it
+ *
+ * Parameters:
+ * name  Name of the scenario
+ * calls Number of library calls the scenario made
+ */
+void endScenario(const __FlashStringHelper *name, long calls)
+{
+  unsigned long elapsed = micros() - scenarioStart;
+  unsigned long transactions = recordingBus.transactionCount();
+  unsigned long bytes = recordingBus.byteCount();
+
+  // Every transaction has a START, the address byte, and a STOP, and every
+  // byte on the wire takes 9 clocks (8 bits and the ACK)
+  unsigned long clocks = transactions * (9 + 2) + bytes * 9;
+
+  Serial.print(name);
+  Serial.print(',');
+  Serial.print(calls);
+  Serial.print(',');
+  Serial.print(elapsed * 1000 / calls);
+  Serial.print(',');
+  Serial.print((float)transactions / calls, 2);
+  Serial.print(',');
+  Serial.print((float)bytes / calls, 2);
+  for (byte i = 0; i < sizeof(clockSpeeds) / sizeof(clockSpeeds[0]); i++)
+  {
+    Serial.print(',');
+    Serial.print((float)clocks * 1000000 / clockSpeeds[i] / calls, 1);
+  }
+  Serial.println();
+}
@@ -0,0 +1,37 @@
+#include <GhostLab42Reboot.h>
+#include <Wire.h>
+
+GhostLab42Reboot reboot;
+
+// A clock on the six-digit display, a stopwatch on the smaller four-digit
+// display, and a countdown on the four-digit display
+GhostLab42RebootTimer timeOfDay(reboot, 0, TIMER_CLOCK);
+GhostLab42RebootTimer stopwatch(reboot, 1, TIMER_STOPWATCH);
+GhostLab42RebootTimer countdown(reboot, 2, TIMER_COUNTDOWN);
+
+void setup()
+{
+  reboot.begin();
+
+  // 12:34:56
+  timeOfDay.start(12 * 3600L + 34 * 60 + 56);
+  stopwatch.start();
+
+  // 5 minutes
+  countdown.start(5 * 60);
+}
+
+void loop()
+{
+  // The timers keep time on their own, no delay() needed
+  timeOfDay.update();
+  stopwatch.update();
+  countdown.update();
+
+  // Start the countdown over once it runs out
+  if (countdown.isExpired())
+  {
+    delay(2000);
+    countdown.start(5 * 60);
+  }
+}
@@ -0,0 +1,94 @@
+/*
+ * The parts of the Arduino core stand-in that are not inline
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "Arduino.h"
+#include "Wire.h"
+
+unsigned long hostMicros = 0;
+TwoWire Wire;
+
+// Like the PORT and DDR bits of an AVR: INPUT_PULLUP sets the output value
+// high, and an output drives whatever the output value is
+static uint8_t pinValues[256];
+static bool pinOutputs[256];
+
+unsigned long hostDrivenHigh = 0;
+int hostHeldPin = -1;
+int hostHeldClockPin = -1;
+int hostHeldPulses = 0;
+
+// Whether the pin is pulling its line low
+static bool drivenLow(uint8_t pin)
+{
+  return pinOutputs[pin] && pinValues[pin] == LOW;
+}
+
+// Counts a pin driving a line high, which an open drain line must never do,
+// and the clock pulses that make a device holding its line let go
+static void checkDrive(uint8_t pin, bool wasLow)
+{
+  if (pinOutputs[pin] && pinValues[pin] == HIGH) hostDrivenHigh++;
+  if (pin == hostHeldClockPin && wasLow == false && drivenLow(pin) && hostHeldPulses > 0)
+  {
+    hostHeldPulses--;
+  }
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  bool wasLow = drivenLow(pin);
+  if (mode == INPUT_PULLUP) pinValues[pin] = HIGH;
+  pinOutputs[pin] = (mode == OUTPUT);
+  checkDrive(pin, wasLow);
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+  bool wasLow = drivenLow(pin);
+  pinValues[pin] = value;
+  checkDrive(pin, wasLow);
+}
+
+int digitalRead(uint8_t pin)
+{
+  if (pin == hostHeldPin && hostHeldPulses > 0) return LOW;
+  return pinValues[pin];
+}
+
+String::String(double value, unsigned char decimals)
+{
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+  text = buffer;
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+  size_t written = 0;
+  while (size--) written += write(*buffer++);
+  return written;
+}
+
+size_t Print::print(long value, int base)
+{
+  char buffer[24];
+  snprintf(buffer, sizeof(buffer), (base == 16) ? "%lX" : "%ld", value);
+  return write(buffer);
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+  char buffer[24];
+  snprintf(buffer, sizeof(buffer), (base == 16) ? "%lX" : "%lu", value);
+  return write(buffer);
+}
+
+size_t Print::print(double value, int decimals)
+{
+  char buffer[48];
+  snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+  return write(buffer);
+}
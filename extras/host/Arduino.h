@@ -0,0 +1,105 @@
+/*
+ * Just enough of the Arduino core to build the GhostLab42Reboot library on a
+ * computer, for the host tests and benchmarks in this directory
+ *
+ * Time only moves when the tests move it (hostMicros), or when the library
+ * waits with delay() or delayMicroseconds()
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+typedef uint8_t byte;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define DEC 10
+
+// There is no separate flash on a computer, so PROGMEM data is plain memory
+#define PROGMEM
+#define PGM_P const char *
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#define pgm_read_word(address) (*(const uint16_t *)(address))
+#define strlen_P strlen
+
+class __FlashStringHelper;
+#define F(text) (reinterpret_cast<const __FlashStringHelper *>(text))
+
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#define constrain(value, low, high) ((value) < (low) ? (low) : ((value) > (high) ? (high) : (value)))
+#define lowByte(w) ((uint8_t)((w) & 0xFF))
+#define highByte(w) ((uint8_t)((w) >> 8))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+
+// The clock the library sees, in microseconds
+extern unsigned long hostMicros;
+
+inline unsigned long micros() { return hostMicros; }
+inline unsigned long millis() { return hostMicros / 1000; }
+// Like on a 16MHz AVR, where the loop count overflows past 16383 microseconds
+inline void delayMicroseconds(unsigned int us) { hostMicros += us % 16384; }
+inline void delay(unsigned long ms) { hostMicros += ms * 1000; }
+
+// Pins read back whatever was last written to them, and float high
+// hostDrivenHigh counts the times an output was driven high. A device can
+// hold hostHeldPin low until hostHeldClockPin has been driven low
+// hostHeldPulses times
+extern unsigned long hostDrivenHigh;
+extern int hostHeldPin;
+extern int hostHeldClockPin;
+extern int hostHeldPulses;
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+class String
+{
+  public:
+    String(const char *text = "") : text(text) {}
+    String(long value) : text(std::to_string(value)) {}
+    String(int value) : text(std::to_string(value)) {}
+    String(double value, unsigned char decimals = 2);
+    const char *c_str() const { return text.c_str(); }
+    unsigned int length() const { return text.size(); }
+  private:
+    std::string text;
+};
+
+class Print
+{
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t character) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *text) { return write((const uint8_t *)text, strlen(text)); }
+    virtual void flush() {}
+
+    size_t print(const char *text) { return write(text); }
+    size_t print(const __FlashStringHelper *text) { return write((const char *)text); }
+    size_t print(const String &text) { return write(text.c_str()); }
+    size_t print(char character) { return write((uint8_t)character); }
+    size_t print(int value, int base = DEC) { return print((long)value, base); }
+    size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int decimals = 2);
+    size_t println() { return write("\r\n"); }
+    template <typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+    template <typename T> size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+};
+
+#endif
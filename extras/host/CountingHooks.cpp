@@ -0,0 +1,18 @@
+/*
+ * The counters behind the timing hooks in CountingHooks.h, built into the
+ * hooks build of the library so every test linked against it has them
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "CountingHooks.h"
+
+unsigned long hookTransactionBegins = 0;
+unsigned long hookTransactionEnds = 0;
+unsigned long hookTransactionFailures = 0;
+unsigned long hookApiBegins = 0;
+unsigned long hookApiEnds = 0;
+int hookApiDepth = 0;
+int hookApiMaxDepth = 0;
+int hookTransactionDepth = 0;
+int hookTransactionsOutsideApi = 0;
@@ -0,0 +1,54 @@
+/*
+ * Fills in the timing hooks from GhostLab42RebootConfig.h with counters, so
+ * the host tests can check where they run. Included ahead of everything else
+ * with -include for the hooks build in CMakeLists.txt
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#ifndef CountingHooks_h
+#define CountingHooks_h
+
+// Defined in CountingHooks.cpp
+extern unsigned long hookTransactionBegins;
+extern unsigned long hookTransactionEnds;
+extern unsigned long hookTransactionFailures;
+extern unsigned long hookApiBegins;
+extern unsigned long hookApiEnds;
+extern int hookApiDepth;
+extern int hookApiMaxDepth;
+extern int hookTransactionDepth;
+extern int hookTransactionsOutsideApi;
+
+inline void countTransactionBegin()
+{
+  hookTransactionBegins++;
+  hookTransactionDepth++;
+  if (hookApiDepth == 0) hookTransactionsOutsideApi++;
+}
+
+inline void countTransactionEnd(unsigned char status)
+{
+  hookTransactionEnds++;
+  hookTransactionDepth--;
+  if (status != 0) hookTransactionFailures++;
+}
+
+inline void countApiBegin()
+{
+  hookApiBegins++;
+  if (++hookApiDepth > hookApiMaxDepth) hookApiMaxDepth = hookApiDepth;
+}
+
+inline void countApiEnd()
+{
+  hookApiEnds++;
+  hookApiDepth--;
+}
+
+#define GHOSTLAB42REBOOT_TRANSACTION_BEGIN(address)       countTransactionBegin()
+#define GHOSTLAB42REBOOT_TRANSACTION_END(address, status) countTransactionEnd(status)
+#define GHOSTLAB42REBOOT_API_BEGIN()                      countApiBegin()
+#define GHOSTLAB42REBOOT_API_END()                        countApiEnd()
+
+#endif
@@ -0,0 +1,174 @@
+/*
+ * Helpers shared by the host tests and benchmarks
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#ifndef HostTest_h
+#define HostTest_h
+
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+#include "GhostLab42Reboot.h"
+
+// Number of checks that failed so far
+static int checkFailures = 0;
+
+#define CHECK(condition) \
+  do \
+  { \
+    if (!(condition)) \
+    { \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+      checkFailures++; \
+    } \
+  } \
+  while (0)
+
+#define CHECK_EQUAL(actual, expected) \
+  do \
+  { \
+    long actualValue = (long)(actual); \
+    long expectedValue = (long)(expected); \
+    if (actualValue != expectedValue) \
+    { \
+      printf("%s:%d: %s is %ld, expected %ld\n", __FILE__, __LINE__, #actual, \
+             actualValue, expectedValue); \
+      checkFailures++; \
+    } \
+  } \
+  while (0)
+
+// Exit code for main(), after saying how it went
+inline int checkResult()
+{
+  if (checkFailures == 0) printf("OK\n");
+  else printf("%d checks failed\n", checkFailures);
+  return (checkFailures == 0) ? 0 : 1;
+}
+
+// A bus that keeps every transaction, answers with results the test sets up
+// ahead of time (0 once there are none left), and moves the host clock along
+// by the time each transaction takes on the wire
+// Successful transactions land in a register file per address, which
+// auto-increments and resets the way the IS31FL3730 does
+class SimulatedBus : public GhostLab42RebootBus
+{
+  public:
+    struct Transaction
+    {
+      unsigned long start;
+      unsigned long end;
+      byte address;
+      std::vector<byte> data;
+      byte status;
+    };
+
+    SimulatedBus(unsigned long clockSpeed = 100000) : clockSpeed(clockSpeed), begun(0)
+    {
+      memset(registers, 0, sizeof(registers));
+    }
+
+    void begin()
+    {
+      begun++;
+    }
+
+    byte transmit(byte address, const byte data[], byte length)
+    {
+      Transaction transaction;
+      transaction.start = hostMicros;
+      transaction.address = address;
+      transaction.data.assign(data, data + length);
+
+      transaction.status = 0;
+      if (results.empty() == false)
+      {
+        transaction.status = results.front();
+        results.pop_front();
+      }
+      for (size_t i = 0; i < missing.size(); i++)
+      {
+        if (missing[i] == address) transaction.status = GHOSTLAB42REBOOT_ERROR_NACK_ADDRESS;
+      }
+
+      // START, the address byte and every data byte with their acknowledge
+      // bits, and the STOP
+      hostMicros += wireTime(length);
+      transaction.end = hostMicros;
+
+      if (transaction.status == 0 && length > 0)
+      {
+        for (byte i = 1; i < length; i++) registers[address & 0x7F][(byte)(data[0] + i - 1)] = data[i];
+
+        // Writing the Reset Register puts every register back to its default
+        if (data[0] == 0xFF && length > 1)
+        {
+          memset(registers[address & 0x7F], 0, sizeof(registers[0]));
+          registers[address & 0x7F][0x19] = 0x80;
+        }
+      }
+
+      log.push_back(transaction);
+      return transaction.status;
+    }
+
+    // Answers the next transactions with these results, in order
+    void fail(byte status, int count = 1)
+    {
+      while (count-- > 0) results.push_back(status);
+    }
+
+    // Transactions to the address are not acknowledged until it is plugged
+    // back in
+    void unplug(byte address)
+    {
+      missing.push_back(address);
+    }
+
+    void plugIn(byte address)
+    {
+      for (size_t i = 0; i < missing.size(); i++)
+      {
+        if (missing[i] == address) missing.erase(missing.begin() + i--);
+      }
+    }
+
+    // Last value written to the register of the device at the address
+    byte registerValue(byte address, byte registerIndex)
+    {
+      return registers[address & 0x7F][registerIndex];
+    }
+
+    // Microseconds on the wire for a transaction of that many bytes, not
+    // counting the address
+    unsigned long wireTime(byte length)
+    {
+      return ((1 + length) * 9 + 2) * 1000000UL / clockSpeed;
+    }
+
+    // Transactions that started at the register, -1 for any register
+    int count(byte address, int firstRegister = -1)
+    {
+      int found = 0;
+      for (size_t i = 0; i < log.size(); i++)
+      {
+        if (log[i].address != address) continue;
+        if (firstRegister >= 0 && (log[i].data.empty() || log[i].data[0] != firstRegister)) continue;
+        found++;
+      }
+      return found;
+    }
+
+    unsigned long clockSpeed;
+    int begun;
+    std::vector<Transaction> log;
+  private:
+    std::deque<byte> results;
+    std::vector<byte> missing;
+    byte registers[128][256];
+};
+
+#endif
@@ -0,0 +1,30 @@
+/*
+ * Stand-in for the Wire library on a computer. Nothing is connected, so
+ * every transaction ends with whatever result is set, 0 (acknowledged) by
+ * default
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#ifndef TwoWire_h
+#define TwoWire_h
+
+#include "Arduino.h"
+
+class TwoWire
+{
+  public:
+    TwoWire() : result(0), begins(0) {}
+    void begin() { begins++; }
+    void end() {}
+    void beginTransmission(uint8_t) {}
+    size_t write(const uint8_t *, size_t length) { return length; }
+    uint8_t endTransmission() { return result; }
+
+    uint8_t result;
+    int begins;
+};
+
+extern TwoWire Wire;
+
+#endif
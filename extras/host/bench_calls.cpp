@@ -0,0 +1,160 @@
+/*
+ * Times the public functions in scenarios modeled on the examples, against
+ * the recording bus, and prints one CSV line per scenario:
+ *
+ * scenario        Which example it is modeled on, and what it calls
+ * calls           Number of calls that were timed
+ * ns_per_call     CPU time per call on this computer
+ * transactions    Transactions per call
+ * bytes           Bytes per call, counting the register index but not the
+ *                 address
+ * wire_us_*       Time on the wire per call at 100kHz, 400kHz, and 1MHz,
+ *                 counting the START, the address, an acknowledge bit for
+ *                 every byte, and the STOP
+ *
+ * Time on the Arduino only moves when a scenario moves it, so scrolling and
+ * fades step exactly as often as they would on the board
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include <chrono>
+#include "HostTest.h"
+
+static const long CALLS = 20000;
+
+static GhostLab42RebootRecordingBus recorder;
+static GhostLab42Reboot reboot(recorder);
+
+typedef void (*Scenario)(long call);
+
+static void report(const char *name, Scenario scenario)
+{
+  hostMicros = 0;
+  recorder.clear();
+  reboot.begin();
+
+  // Get the first write to every register out of the way, that only happens
+  // once on the board
+  scenario(0);
+  recorder.clear();
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (long call = 1; call <= CALLS; call++) scenario(call);
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+  double transactions = (double)recorder.transactionCount() / CALLS;
+  double bytes = (double)recorder.byteCount() / CALLS;
+  double bits = 9 * (transactions + bytes) + 2 * transactions;
+
+  printf("%s,%ld,%.1f,%.2f,%.2f,%.1f,%.1f,%.1f\n", name, CALLS, ns / CALLS,
+         transactions, bytes, bits * 10.0, bits * 2.5, bits * 1.0);
+}
+
+// ex1: all three displays flashing between two sets of numbers in a frame
+static void flashFrame(long call)
+{
+  reboot.beginFrame();
+  reboot.write(0, (call & 1) ? "9146431" : "1709752");
+  reboot.write(1, (call & 1) ? "1923" : "8210");
+  reboot.write(2, (call & 1) ? "5678" : "4251");
+  reboot.endFrame();
+}
+
+// ex1: the six digit display flashing on its own
+static void flashWrite(long call)
+{
+  reboot.write(0, (call & 1) ? "9146431" : "1709752");
+}
+
+// ex1: writing what the display already shows
+static void repeatWrite(long)
+{
+  reboot.write(0, "9146431");
+}
+
+// ex2: stepping the brightness by hand
+static void setBrightness(long call)
+{
+  reboot.setDisplayBrightness(0, call % 101);
+}
+
+// ex2: fading all three displays up and down over two seconds, with update()
+// called every millisecond
+static bool fadingUp = false;
+
+static void fade(long)
+{
+  hostMicros += 1000;
+  if (reboot.isFading(0) == false)
+  {
+    fadingUp = !fadingUp;
+    reboot.fadeTo(0, fadingUp ? 100 : 0, 2000);
+    reboot.fadeTo(1, fadingUp ? 50 : 0, 2000, EASE_IN_OUT);
+    reboot.fadeTo(2, fadingUp ? 0 : 100, 2000);
+  }
+  reboot.update();
+}
+
+// ex3: scrolling a line of text, with update() called every millisecond
+static void scroll(long)
+{
+  hostMicros += 1000;
+  if (reboot.isScrolling(0) == false)
+  {
+    reboot.scroll(0, "      Who ya gonna call?     Ghostbusters!      ", 250);
+  }
+  reboot.update();
+}
+
+// ex4: a number with decimals
+static void writeNumber(long call)
+{
+  reboot.writeNumber(0, call, 2);
+}
+
+// ex5: counting down on one display and up on another
+static GhostLab42RebootCounter countdown(reboot, 0, ' ');
+static GhostLab42RebootCounter countup(reboot, 1, '0');
+
+static void count(long call)
+{
+  if (call == 0)
+  {
+    countdown.set(120999L);
+    countup.set(0);
+  }
+  countdown.decrement();
+  countup.increment(16);
+}
+
+// ex5: a noisy reading every 30 milliseconds
+static GhostLab42RebootFilter reading(reboot, 2, 1, 500);
+
+static void filter(long call)
+{
+  hostMicros += 30000;
+  reading.write(2087 + (int32_t)((call * 7) % 5) - 2);
+}
+
+// Clearing a display
+static void reset(long)
+{
+  reboot.resetDisplay(1);
+}
+
+int main()
+{
+  printf("scenario,calls,ns_per_call,transactions,bytes,wire_us_100khz,wire_us_400khz,wire_us_1mhz\n");
+  report("ex1_frame", flashFrame);
+  report("ex1_write", flashWrite);
+  report("ex1_write_unchanged", repeatWrite);
+  report("ex2_setDisplayBrightness", setBrightness);
+  report("ex2_fade_update", fade);
+  report("ex3_scroll_update", scroll);
+  report("ex4_writeNumber", writeNumber);
+  report("ex5_counter", count);
+  report("ex5_filter", filter);
+  report("resetDisplay", reset);
+  return 0;
+}
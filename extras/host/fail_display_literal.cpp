@@ -0,0 +1,13 @@
+/*
+ * Must not compile: the string literal has more characters than the six
+ * digit display can ever show
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "GhostLab42Reboot.h"
+
+void writeTooMuch(GhostLab42Reboot &reboot)
+{
+  reboot.display<0>().write("1234567890123");
+}
@@ -0,0 +1,27 @@
+/*
+ * Must compile: string literals that fit exactly, counting decimals in the
+ * digit in front of them and M/W as two digits, and fits() agreeing with
+ * what write() encodes. The positive control for fail_display_literal
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "GhostLab42Reboot.h"
+
+static_assert(GhostLab42RebootSix::fits("123456"), "six digits fit");
+static_assert(GhostLab42RebootSix::fits("1.2.3.4.5.6."), "decimals share a digit");
+static_assert(GhostLab42RebootSix::fits(".1.2.3.4.5"), "a leading decimal takes a digit");
+static_assert(GhostLab42RebootSix::fits("MW.M"), "M and W take two digits each");
+static_assert(GhostLab42RebootFour::fits("1..2.3"), "a second decimal takes a digit");
+static_assert(GhostLab42RebootFour::fits("MW"), "M and W take two digits each");
+static_assert(!GhostLab42RebootFour::fits("12345"), "five digits do not fit in four");
+static_assert(!GhostLab42RebootFour::fits("MW1"), "M and W take two digits each");
+static_assert(!GhostLab42RebootFour::fits("1...2.3"), "a second decimal takes a digit");
+static_assert(!GhostLab42RebootSix::fits("1234567"), "seven digits do not fit in six");
+
+void writeExactly(GhostLab42Reboot &reboot)
+{
+  reboot.display<0>().write("1.2.3.4.5.6.");
+  reboot.display<1>().write("M.W.");
+  reboot.display<2>().write("1234");
+}
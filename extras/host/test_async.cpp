@@ -0,0 +1,127 @@
+/*
+ * Checks the async mode queue against the simulated bus: writes only queue
+ * their transactions, update() sends one at a time without waiting out the
+ * backoff of a retry, and every result goes to the completion callback in
+ * order
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "HostTest.h"
+
+struct Completion
+{
+  int displayID;
+  byte status;
+};
+
+static std::vector<Completion> completions;
+
+static void completed(int displayID, byte status)
+{
+  Completion completion = {displayID, status};
+  completions.push_back(completion);
+}
+
+int main()
+{
+  SimulatedBus wire;
+  GhostLab42Reboot reboot(wire);
+  CHECK_EQUAL(reboot.begin(POWER_ASSERT_ON_ERROR), GHOSTLAB42REBOOT_OK);
+  reboot.setCompletionCallback(completed);
+  CHECK_EQUAL(reboot.setAsyncMode(true), GHOSTLAB42REBOOT_OK);
+  CHECK(reboot.isIdle());
+
+  // Writing to all three displays does not touch the bus or take any time
+  size_t sent = wire.log.size();
+  unsigned long start = hostMicros;
+  CHECK_EQUAL(reboot.write(0, "123456"), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(reboot.write(1, "1234"), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(reboot.write(2, "5678"), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log.size(), sent);
+  CHECK_EQUAL(hostMicros, start);
+  CHECK(reboot.isIdle() == false);
+  CHECK_EQUAL(completions.size(), 0);
+
+  // Each update() sends the oldest transaction and reports it
+  for (int i = 0; i < 3; i++)
+  {
+    CHECK_EQUAL(reboot.update(), GHOSTLAB42REBOOT_OK);
+    CHECK_EQUAL(wire.log.size(), sent + i + 1);
+    CHECK_EQUAL(completions.size(), i + 1);
+    CHECK_EQUAL(completions.back().displayID, i);
+    CHECK_EQUAL(completions.back().status, GHOSTLAB42REBOOT_OK);
+  }
+  CHECK(reboot.isIdle());
+  CHECK_EQUAL(wire.registerValue(0x60, 0x01), 0x06);
+  CHECK_EQUAL(wire.registerValue(0x61, 0x04), 0x66);
+  CHECK_EQUAL(wire.registerValue(0x63, 0x01), 0x6D);
+  CHECK_EQUAL(wire.count(0x63, 0x01), 1);
+
+  // Nothing is left to send, so update() stays off the bus
+  CHECK_EQUAL(reboot.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log.size(), sent + 3);
+
+  // A transaction that keeps failing is reported once, after its retries
+  completions.clear();
+  wire.fail(GHOSTLAB42REBOOT_ERROR_NACK_DATA, 3);
+  CHECK_EQUAL(reboot.write(1, "4321"), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(reboot.write(2, "8765"), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(reboot.flush(), GHOSTLAB42REBOOT_ERROR_NACK_DATA);
+  CHECK(reboot.isIdle());
+  CHECK_EQUAL(completions.size(), 2);
+  CHECK_EQUAL(completions[0].displayID, 1);
+  CHECK_EQUAL(completions[0].status, GHOSTLAB42REBOOT_ERROR_NACK_DATA);
+  CHECK_EQUAL(completions[1].displayID, 2);
+  CHECK_EQUAL(completions[1].status, GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(reboot.getErrorCounts(1).nackData, 3);
+
+  // In update(), a failed attempt is tried again by a later update() once
+  // its backoff is over, rather than holding up loop() waiting for it
+  completions.clear();
+  reboot.setRetryPolicy(2, 1000);
+  wire.fail(GHOSTLAB42REBOOT_ERROR_NACK_DATA, 1);
+  CHECK_EQUAL(reboot.write(2, "1111"), GHOSTLAB42REBOOT_OK);
+  sent = wire.log.size();
+  CHECK_EQUAL(reboot.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log.size(), sent + 1);
+  CHECK(hostMicros - wire.log.back().end < 1000);
+  CHECK_EQUAL(completions.size(), 0);
+  CHECK(reboot.isIdle() == false);
+
+  CHECK_EQUAL(reboot.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log.size(), sent + 1);
+
+  hostMicros += 1000;
+  CHECK_EQUAL(reboot.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log.size(), sent + 2);
+  CHECK(reboot.isIdle());
+  CHECK_EQUAL(completions.size(), 1);
+  CHECK_EQUAL(completions[0].status, GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.registerValue(0x63, 0x01), 0x06);
+  CHECK_EQUAL(reboot.getErrorCounts(2).nackData, 1);
+  reboot.setRetryPolicy(GHOSTLAB42REBOOT_RETRIES, GHOSTLAB42REBOOT_RETRY_BACKOFF);
+
+  // Filling the queue sends the oldest transaction to make room
+  completions.clear();
+  sent = wire.log.size();
+  for (int i = 0; i < GHOSTLAB42REBOOT_QUEUE_LENGTH + 1; i++)
+  {
+    CHECK_EQUAL(reboot.setDisplayBrightness(0, 10 + i), GHOSTLAB42REBOOT_OK);
+  }
+  CHECK_EQUAL(wire.log.size(), sent + 1);
+  CHECK_EQUAL(completions.size(), 1);
+
+  // Turning async mode off sends everything that is still waiting
+  CHECK_EQUAL(reboot.setAsyncMode(false), GHOSTLAB42REBOOT_OK);
+  CHECK(reboot.isIdle());
+  CHECK_EQUAL(wire.log.size(), sent + GHOSTLAB42REBOOT_QUEUE_LENGTH + 1);
+  CHECK_EQUAL(completions.size(), GHOSTLAB42REBOOT_QUEUE_LENGTH + 1);
+
+  // Without async mode, the write is on the bus before it returns
+  sent = wire.log.size();
+  CHECK_EQUAL(reboot.write(0, "654321"), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log.size(), sent + 1);
+
+  return checkResult();
+}
@@ -0,0 +1,131 @@
+/*
+ * Checks GhostLab42RebootCounter against the simulated bus: carrying and
+ * borrowing between digits, rolling over at the width of the display, the
+ * padding in front of the count, and that each step only sends the data
+ * registers from the first digit that changed
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "HostTest.h"
+#include "GhostLab42RebootCounter.h"
+
+static SimulatedBus wire;
+static GhostLab42Reboot reboot(wire);
+
+static const byte addresses[] = {0x60, 0x61, 0x63};
+
+// Whether the display shows the same digits as after writing the text
+static bool shows(int displayID, const char *text)
+{
+  byte shown[GHOSTLAB42REBOOT_DATA_REGISTERS];
+  byte address = addresses[displayID];
+  for (int i = 0; i < GHOSTLAB42REBOOT_DATA_REGISTERS; i++) shown[i] = wire.registerValue(address, 0x01 + i);
+
+  reboot.resetDisplay(displayID);
+  reboot.write(displayID, text);
+  bool same = true;
+  for (int i = 0; i < GHOSTLAB42REBOOT_DATA_REGISTERS; i++)
+  {
+    if (wire.registerValue(address, 0x01 + i) != shown[i]) same = false;
+  }
+  if (same == false)
+  {
+    printf("display %d does not show \"%s\":", displayID, text);
+    for (int i = 0; i < GHOSTLAB42REBOOT_DATA_REGISTERS; i++) printf(" %02X", shown[i]);
+    printf("\n");
+  }
+  return same;
+}
+
+// Bytes in the one transaction a step should take: the register index, the
+// data registers from the first digit that changed up to 0x0B, and the
+// update
+static size_t burst(int firstDigit)
+{
+  return 1 + (GHOSTLAB42REBOOT_DATA_REGISTERS - firstDigit) + 1;
+}
+
+// Checks that the last call sent a single burst starting at the digit
+#define CHECK_BURST(sent, firstDigit) \
+  do \
+  { \
+    CHECK_EQUAL(wire.log.size(), (sent) + 1); \
+    CHECK_EQUAL(wire.log.back().data[0], 0x01 + (firstDigit)); \
+    CHECK_EQUAL(wire.log.back().data.size(), burst(firstDigit)); \
+  } \
+  while (0)
+
+int main()
+{
+  CHECK_EQUAL(reboot.begin(POWER_ASSERT_ON_ERROR), GHOSTLAB42REBOOT_OK);
+
+  // Leading zeros like an odometer, on the four digit display
+  GhostLab42RebootCounter odometer(reboot, 1);
+  CHECK_EQUAL(odometer.set(7), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(1, "0007"));
+
+  // A step that does not carry only sends the last digit
+  CHECK_EQUAL(odometer.set(1234), GHOSTLAB42REBOOT_OK);
+  size_t sent = wire.log.size();
+  CHECK_EQUAL(odometer.increment(), GHOSTLAB42REBOOT_OK);
+  CHECK_BURST(sent, 3);
+  CHECK_EQUAL(odometer.getValue(), 1235);
+
+  // Carrying sends from the last digit it reached
+  CHECK_EQUAL(odometer.set(1239), GHOSTLAB42REBOOT_OK);
+  sent = wire.log.size();
+  CHECK_EQUAL(odometer.increment(), GHOSTLAB42REBOOT_OK);
+  CHECK_BURST(sent, 2);
+  CHECK(shows(1, "1240"));
+
+  CHECK_EQUAL(odometer.set(1999), GHOSTLAB42REBOOT_OK);
+  sent = wire.log.size();
+  CHECK_EQUAL(odometer.increment(), GHOSTLAB42REBOOT_OK);
+  CHECK_BURST(sent, 0);
+  CHECK(shows(1, "2000"));
+
+  // More than one step at a time carries the same way
+  CHECK_EQUAL(odometer.increment(123), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(odometer.getValue(), 2123);
+  CHECK_EQUAL(odometer.decrement(124), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(odometer.getValue(), 1999);
+
+  // Borrowing does too
+  CHECK_EQUAL(odometer.set(1000), GHOSTLAB42REBOOT_OK);
+  sent = wire.log.size();
+  CHECK_EQUAL(odometer.decrement(), GHOSTLAB42REBOOT_OK);
+  CHECK_BURST(sent, 0);
+  CHECK(shows(1, "0999"));
+
+  // Rolls over at the width of the display, both ways
+  CHECK_EQUAL(odometer.set(9999), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(odometer.increment(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(odometer.getValue(), 0);
+  CHECK(shows(1, "0000"));
+  CHECK_EQUAL(odometer.decrement(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(odometer.getValue(), 9999);
+  CHECK(shows(1, "9999"));
+
+  // Setting more than fits drops the digits in front
+  CHECK_EQUAL(odometer.set(123456), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(odometer.getValue(), 3456);
+  CHECK(shows(1, "3456"));
+
+  // Blank padding on the six digit display moves along with the count
+  GhostLab42RebootCounter count(reboot, 0, ' ');
+  CHECK_EQUAL(count.set(0), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(0, "     0"));
+  CHECK_EQUAL(count.set(99), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(0, "    99"));
+  sent = wire.log.size();
+  CHECK_EQUAL(count.increment(), GHOSTLAB42REBOOT_OK);
+  CHECK_BURST(sent, 3);
+  CHECK(shows(0, "   100"));
+  sent = wire.log.size();
+  CHECK_EQUAL(count.decrement(), GHOSTLAB42REBOOT_OK);
+  CHECK_BURST(sent, 3);
+  CHECK(shows(0, "    99"));
+
+  return checkResult();
+}
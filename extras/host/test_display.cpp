@@ -0,0 +1,87 @@
+/*
+ * Checks that every kind of string reaches the display handles, and goes out
+ * the same as through the display ID
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "HostTest.h"
+
+static SimulatedBus wire;
+static GhostLab42Reboot reboot(wire);
+
+// Whether the six digit display holds the same digits as after writing the
+// text through its display ID
+static bool showsSame(const char *text)
+{
+  byte shown[GHOSTLAB42REBOOT_DATA_REGISTERS];
+  for (int i = 0; i < GHOSTLAB42REBOOT_DATA_REGISTERS; i++) shown[i] = wire.registerValue(0x60, 0x01 + i);
+
+  reboot.resetDisplay(0);
+  reboot.write(0, text);
+  for (int i = 0; i < GHOSTLAB42REBOOT_DATA_REGISTERS; i++)
+  {
+    if (wire.registerValue(0x60, 0x01 + i) != shown[i]) return false;
+  }
+  return true;
+}
+
+int main()
+{
+  CHECK_EQUAL(reboot.begin(), GHOSTLAB42REBOOT_OK);
+  GhostLab42RebootSix six = reboot.display<0>();
+
+  CHECK_EQUAL(six.id, 0);
+  CHECK_EQUAL(six.address, 0x60);
+  CHECK_EQUAL(six.digits, 6);
+
+  // String literal
+  reboot.resetDisplay(0);
+  CHECK_EQUAL(six.write("12.34"), GHOSTLAB42REBOOT_OK);
+  CHECK(showsSame("12.34"));
+
+  // Constant array, shorter than the array
+  static const char constant[8] = "ABC";
+  reboot.resetDisplay(0);
+  CHECK_EQUAL(six.write(constant), GHOSTLAB42REBOOT_OK);
+  CHECK(showsSame("ABC"));
+
+  // Array filled in at run time, which may be longer than the display
+  char buffer[16];
+  snprintf(buffer, sizeof(buffer), "%d.%d", 4321, 5);
+  reboot.resetDisplay(0);
+  CHECK_EQUAL(six.write(buffer), GHOSTLAB42REBOOT_OK);
+  CHECK(showsSame("4321.5"));
+
+  // Array without a terminator stops at the end of the array
+  char unterminated[3] = {'9', '8', '7'};
+  reboot.resetDisplay(0);
+  CHECK_EQUAL(six.write(unterminated), GHOSTLAB42REBOOT_OK);
+  CHECK(showsSame("987"));
+
+  // Pointers
+  const char *pointer = buffer + 2;
+  reboot.resetDisplay(0);
+  CHECK_EQUAL(six.write(pointer), GHOSTLAB42REBOOT_OK);
+  CHECK(showsSame("21.5"));
+
+  char *mutablePointer = buffer;
+  reboot.resetDisplay(0);
+  CHECK_EQUAL(six.write(mutablePointer), GHOSTLAB42REBOOT_OK);
+  CHECK(showsSame("4321.5"));
+
+  // Everything else
+  reboot.resetDisplay(0);
+  CHECK_EQUAL(six.write(buffer, 2), GHOSTLAB42REBOOT_OK);
+  CHECK(showsSame("43"));
+
+  reboot.resetDisplay(0);
+  CHECK_EQUAL(six.write(F("HELLO")), GHOSTLAB42REBOOT_OK);
+  CHECK(showsSame("HELLO"));
+
+  reboot.resetDisplay(0);
+  CHECK_EQUAL(six.write(String("5.5")), GHOSTLAB42REBOOT_OK);
+  CHECK(showsSame("5.5"));
+
+  return checkResult();
+}
@@ -0,0 +1,107 @@
+/*
+ * Checks fadeTo() against the simulated bus: where the fade starts and ends,
+ * the easing at the halfway point, that the PWM Register is only written
+ * when the value for it changes, and that setDisplayBrightness() stops it
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "HostTest.h"
+
+static SimulatedBus wire;
+static GhostLab42Reboot reboot(wire);
+
+// PWM Register value for a brightness percentage, by setting display 2 to it
+static byte pwmFor(int brightness)
+{
+  reboot.setDisplayBrightness(2, brightness);
+  return wire.registerValue(0x63, 0x19);
+}
+
+// PWM Register writes to the six digit display since the given transaction
+static std::vector<byte> pwmWrites(size_t since)
+{
+  std::vector<byte> values;
+  for (size_t i = since; i < wire.log.size(); i++)
+  {
+    const SimulatedBus::Transaction &transaction = wire.log[i];
+    if (transaction.address == 0x60 && transaction.data.size() == 2 && transaction.data[0] == 0x19)
+    {
+      values.push_back(transaction.data[1]);
+    }
+  }
+  return values;
+}
+
+int main()
+{
+  CHECK_EQUAL(reboot.begin(POWER_ASSERT_ON_ERROR), GHOSTLAB42REBOOT_OK);
+  byte full = pwmFor(100);
+  byte half = pwmFor(50);
+  byte quarterOff = pwmFor(75);
+  byte off = pwmFor(0);
+  CHECK_EQUAL(reboot.setDisplayBrightness(0, 100), GHOSTLAB42REBOOT_OK);
+
+  // The first step is the level it starts at, which is already there
+  size_t sent = wire.log.size();
+  CHECK_EQUAL(reboot.fadeTo(0, 0, 1000), GHOSTLAB42REBOOT_OK);
+  CHECK(reboot.isFading(0));
+  CHECK_EQUAL(wire.log.size(), sent);
+
+  // Halfway through a linear fade is halfway between the levels
+  hostMicros += 500000;
+  CHECK_EQUAL(reboot.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.registerValue(0x60, 0x19), half);
+
+  // It ends exactly at the target, once the time is up
+  hostMicros += 500000;
+  CHECK_EQUAL(reboot.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.registerValue(0x60, 0x19), off);
+  CHECK(reboot.isFading(0) == false);
+  sent = wire.log.size();
+  hostMicros += 500000;
+  CHECK_EQUAL(reboot.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log.size(), sent);
+
+  // Easing in covers a quarter of the way by the halfway point
+  CHECK_EQUAL(reboot.setDisplayBrightness(0, 100), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(reboot.fadeTo(0, 0, 1000, EASE_IN), GHOSTLAB42REBOOT_OK);
+  hostMicros += 500000;
+  CHECK_EQUAL(reboot.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.registerValue(0x60, 0x19), quarterOff);
+
+  // With update() called every millisecond, the PWM Register is only written
+  // when its value changes, and never with the same value twice in a row
+  CHECK_EQUAL(reboot.setDisplayBrightness(0, 100), GHOSTLAB42REBOOT_OK);
+  sent = wire.log.size();
+  CHECK_EQUAL(reboot.fadeTo(0, 0, 1000), GHOSTLAB42REBOOT_OK);
+  for (int i = 0; i < 1000; i++)
+  {
+    hostMicros += 1000;
+    CHECK_EQUAL(reboot.update(), GHOSTLAB42REBOOT_OK);
+  }
+  CHECK(reboot.isFading(0) == false);
+  std::vector<byte> writes = pwmWrites(sent);
+  CHECK(writes.size() > 1);
+  CHECK(writes.size() < 100);
+  CHECK(writes.front() != full);
+  CHECK_EQUAL(writes.back(), off);
+  for (size_t i = 1; i < writes.size(); i++) CHECK(writes[i] != writes[i - 1]);
+  CHECK_EQUAL(wire.log.size() - sent, writes.size());
+
+  // Setting the brightness stops the fade where it is
+  CHECK_EQUAL(reboot.fadeTo(0, 100, 1000), GHOSTLAB42REBOOT_OK);
+  hostMicros += 300000;
+  CHECK_EQUAL(reboot.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(reboot.setDisplayBrightness(0, 20), GHOSTLAB42REBOOT_OK);
+  CHECK(reboot.isFading(0) == false);
+  byte set = wire.registerValue(0x60, 0x19);
+  sent = wire.log.size();
+  hostMicros += 1000000;
+  CHECK_EQUAL(reboot.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log.size(), sent);
+  CHECK_EQUAL(wire.registerValue(0x60, 0x19), set);
+  CHECK_EQUAL(set, pwmFor(20));
+
+  return checkResult();
+}
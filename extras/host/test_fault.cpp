@@ -0,0 +1,93 @@
+/*
+ * Checks what happens when the bus hangs: every display on it gets its power
+ * setting, its whole shadow copy, and its brightness again, in that order,
+ * and clearing the bus by hand only ever pulls the lines low
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "HostTest.h"
+#include <Wire.h>
+
+// Checks that the transactions from the index on replay each display in
+// turn: the current limit, every data register with the update, then the
+// brightness
+static void checkReplay(SimulatedBus &wire, size_t from, int firstDisplay, int displays)
+{
+  static const byte addresses[] = {0x60, 0x61, 0x63};
+
+  CHECK_EQUAL(wire.log.size() - from, 3 * displays);
+  for (int i = 0; i < displays && from + 3 * i + 2 < wire.log.size(); i++)
+  {
+    const SimulatedBus::Transaction *replay = &wire.log[from + 3 * i];
+    byte address = addresses[firstDisplay + i];
+    for (int j = 0; j < 3; j++) CHECK_EQUAL(replay[j].address, address);
+
+    CHECK_EQUAL(replay[0].data[0], 0x0D);
+    CHECK_EQUAL(replay[1].data[0], 0x01);
+    CHECK_EQUAL(replay[1].data.size(), 1 + GHOSTLAB42REBOOT_DATA_REGISTERS + 1);
+    CHECK_EQUAL(replay[2].data[0], 0x19);
+  }
+}
+
+int main()
+{
+  SimulatedBus wire;
+  GhostLab42Reboot reboot(wire);
+  CHECK_EQUAL(reboot.begin(POWER_ASSERT_ON_ERROR), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(reboot.write(0, "123456"), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(reboot.write(1, "1234"), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(reboot.write(2, "5678"), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(reboot.setDisplayBrightness(2, 50), GHOSTLAB42REBOOT_OK);
+
+  // The bus times out once, and the retry goes through, but every display
+  // on the bus still gets replayed since whatever hung the bus was most
+  // likely a board losing power
+  wire.fail(GHOSTLAB42REBOOT_ERROR_TIMEOUT);
+  size_t sent = wire.log.size();
+  CHECK_EQUAL(reboot.write(1, "4321"), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log[sent].status, GHOSTLAB42REBOOT_ERROR_TIMEOUT);
+  CHECK_EQUAL(wire.log[sent + 1].status, GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log[sent + 1].data[0], wire.log[sent].data[0]);
+  checkReplay(wire, sent + 2, 0, 3);
+  CHECK_EQUAL(wire.registerValue(0x61, 0x01), 0x66);
+  CHECK_EQUAL(wire.registerValue(0x60, 0x06), 0x7D);
+  CHECK_EQUAL(wire.registerValue(0x63, 0x19), wire.log.back().data[1]);
+  CHECK(reboot.isIdle());
+
+  // The bus hangs again while the first display is being replayed, so the
+  // other two are finished and the first is left for update()
+  wire.fail(GHOSTLAB42REBOOT_ERROR_TIMEOUT);
+  wire.fail(GHOSTLAB42REBOOT_OK);
+  wire.fail(GHOSTLAB42REBOOT_ERROR_TIMEOUT);
+  sent = wire.log.size();
+  CHECK_EQUAL(reboot.write(1, "1111"), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log[sent + 2].address, 0x60);
+  CHECK_EQUAL(wire.log[sent + 2].status, GHOSTLAB42REBOOT_ERROR_TIMEOUT);
+  CHECK_EQUAL(wire.log[sent + 3].status, GHOSTLAB42REBOOT_OK);
+  sent = wire.log.size();
+  CHECK_EQUAL(reboot.update(), GHOSTLAB42REBOOT_OK);
+  checkReplay(wire, sent, 0, 1);
+
+  // Clearing a stuck bus by hand clocks until the device holding the data
+  // line lets go, without ever driving either line high
+  const int sdaPin = 18;
+  const int sclPin = 19;
+  GhostLab42RebootWireBus wireBus(Wire, sdaPin, sclPin);
+  hostHeldPin = sdaPin;
+  hostHeldClockPin = sclPin;
+  hostHeldPulses = 3;
+  wireBus.begin();
+  CHECK_EQUAL(hostHeldPulses, 0);
+  CHECK_EQUAL(hostDrivenHigh, 0);
+  CHECK_EQUAL(Wire.begins, 1);
+
+  // A timeout from the Wire library clears the bus and starts it again
+  Wire.result = GHOSTLAB42REBOOT_ERROR_TIMEOUT;
+  byte data[] = {0x19, 0x00};
+  CHECK_EQUAL(wireBus.transmit(0x60, data, sizeof(data)), GHOSTLAB42REBOOT_ERROR_TIMEOUT);
+  CHECK_EQUAL(Wire.begins, 2);
+  CHECK_EQUAL(hostDrivenHigh, 0);
+
+  return checkResult();
+}
@@ -0,0 +1,99 @@
+/*
+ * Checks GhostLab42RebootFilter against the simulated bus: the deadband and
+ * hold time keep readings off the display without touching the bus, the
+ * running average follows the readings without overflowing, and suppressed
+ * readings are counted in the stats too
+ *
+ * Built with the stats turned on
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "HostTest.h"
+#include "GhostLab42RebootFilter.h"
+
+static SimulatedBus wire;
+static GhostLab42Reboot reboot(wire);
+
+int main()
+{
+  CHECK_EQUAL(reboot.begin(POWER_ASSERT_ON_ERROR), GHOSTLAB42REBOOT_OK);
+
+  // Readings within the deadband leave the display and the bus alone
+  GhostLab42RebootFilter deadband(reboot, 0, 1);
+  CHECK_EQUAL(deadband.write(2087), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.registerValue(0x60, 0x03), 0x5B);
+  size_t sent = wire.log.size();
+  CHECK_EQUAL(deadband.write(2088), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(deadband.write(2086), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log.size(), sent);
+  CHECK_EQUAL(deadband.getValue(), 2087);
+  CHECK_EQUAL(deadband.getSuppressedCount(), 2);
+  CHECK_EQUAL(deadband.write(2089), GHOSTLAB42REBOOT_OK);
+  CHECK(wire.log.size() > sent);
+  CHECK_EQUAL(deadband.getValue(), 2089);
+
+  // Changing the decimals always changes the display
+  CHECK_EQUAL(deadband.write(2089, 1), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(deadband.getSuppressedCount(), 2);
+
+  // A value stays up for the hold time, however far the readings move
+  GhostLab42RebootFilter hold(reboot, 1, 0, 500);
+  unsigned long written = hostMicros;
+  CHECK_EQUAL(hold.write(1), GHOSTLAB42REBOOT_OK);
+  hostMicros = written + 499000;
+  sent = wire.log.size();
+  CHECK_EQUAL(hold.write(9), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log.size(), sent);
+  CHECK_EQUAL(hold.getValue(), 1);
+  hostMicros += 1000;
+  CHECK_EQUAL(hold.write(9), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(hold.getValue(), 9);
+  CHECK_EQUAL(wire.registerValue(0x61, 0x04), 0x6F);
+
+  // Each reading moves the average a quarter of the way towards it, and the
+  // first one starts it off
+  GhostLab42RebootFilter average(reboot, 2, 0, 0, 2);
+  CHECK_EQUAL(average.write(100), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(average.getValue(), 100);
+  CHECK_EQUAL(average.write(200), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(average.getValue(), 125);
+  CHECK_EQUAL(average.write(200), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(average.getValue(), 144);
+  CHECK_EQUAL(average.write(-200), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(average.getValue(), 58);
+
+  // A steady reading the average has settled on is suppressed
+  average.reset();
+  CHECK_EQUAL(average.write(42), GHOSTLAB42REBOOT_OK);
+  unsigned long suppressed = average.getSuppressedCount();
+  CHECK_EQUAL(average.write(42), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(average.getSuppressedCount(), suppressed + 1);
+
+  // Readings past 2^23 do not wrap around once the average is shifted over,
+  // so one too big for the display shows as an overflow
+  GhostLab42RebootFilter large(reboot, 0, 0, 0, 3);
+  CHECK_EQUAL(large.write(16777221), GHOSTLAB42REBOOT_ERROR_OVERFLOW);
+  CHECK_EQUAL(large.getValue(), 16777221);
+  CHECK_EQUAL(wire.registerValue(0x60, 0x01), 0x40);
+  CHECK_EQUAL(large.write(2147483647L), GHOSTLAB42REBOOT_ERROR_OVERFLOW);
+  CHECK(large.getValue() > 16777221);
+  large.reset();
+  CHECK_EQUAL(large.write(-2147483647L - 1), GHOSTLAB42REBOOT_ERROR_OVERFLOW);
+  CHECK_EQUAL(large.getValue(), -2147483647L - 1);
+
+  // Smoothing past 16 is held at 16, rather than shifting past the width of
+  // the divisor
+  GhostLab42RebootFilter slow(reboot, 2, 0, 0, 200);
+  CHECK_EQUAL(slow.write(1000), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(slow.write(2000), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(slow.getValue(), 1000);
+
+  // Every suppressed reading is in the stats of its display too
+  CHECK_EQUAL(reboot.stats(0).suppressedWrites, deadband.getSuppressedCount());
+  CHECK_EQUAL(reboot.stats(1).suppressedWrites, hold.getSuppressedCount());
+  CHECK_EQUAL(reboot.stats(2).suppressedWrites,
+              average.getSuppressedCount() + slow.getSuppressedCount());
+
+  return checkResult();
+}
@@ -0,0 +1,132 @@
+/*
+ * Checks how writeFixed() rounds off the decimals that do not fit
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "HostTest.h"
+
+static SimulatedBus wire;
+static GhostLab42Reboot reboot(wire);
+
+static const byte addresses[] = {0x60, 0x61, 0x63};
+
+// Whether the display shows the same digits as after writing the text
+static bool shows(int displayID, const char *text)
+{
+  byte shown[GHOSTLAB42REBOOT_DATA_REGISTERS];
+  byte address = addresses[displayID];
+  for (int i = 0; i < GHOSTLAB42REBOOT_DATA_REGISTERS; i++) shown[i] = wire.registerValue(address, 0x01 + i);
+
+  reboot.resetDisplay(displayID);
+  reboot.write(displayID, text);
+  bool same = true;
+  for (int i = 0; i < GHOSTLAB42REBOOT_DATA_REGISTERS; i++)
+  {
+    if (wire.registerValue(address, 0x01 + i) != shown[i]) same = false;
+  }
+  if (same == false)
+  {
+    printf("display %d does not show \"%s\":", displayID, text);
+    for (int i = 0; i < GHOSTLAB42REBOOT_DATA_REGISTERS; i++) printf(" %02X", shown[i]);
+    printf("\n");
+  }
+  return same;
+}
+
+int main()
+{
+  // A six digit, a four digit, and a two digit board
+  const GhostLab42RebootBoard boards[] = {{0x60, 6, NULL}, {0x61, 4, NULL}, {0x63, 2, NULL}};
+  CHECK_EQUAL(reboot.begin(boards, 3), GHOSTLAB42REBOOT_OK);
+
+  // Rounded once from the original value, not one decimal at a time
+  reboot.resetDisplay(1);
+  CHECK_EQUAL(reboot.writeFixed(1, 123449L, 3), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(1, "123.4"));
+
+  reboot.resetDisplay(2);
+  CHECK_EQUAL(reboot.writeFixed(2, 1249L, 2), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(2, "12"));
+
+  reboot.resetDisplay(1);
+  CHECK_EQUAL(reboot.writeFixed(1, -123449L, 3), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(1, "-123"));
+
+  // Halves round away from zero
+  reboot.resetDisplay(1);
+  CHECK_EQUAL(reboot.writeFixed(1, 12625L, 2), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(1, "126.3"));
+
+  reboot.resetDisplay(1);
+  CHECK_EQUAL(reboot.writeFixed(1, -12625L, 2), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(1, "-126"));
+
+  // Rounding up can carry into another digit
+  reboot.resetDisplay(1);
+  CHECK_EQUAL(reboot.writeFixed(1, 99996L, 3), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(1, "100.0"));
+
+  // Numbers that fit are left alone
+  reboot.resetDisplay(0);
+  CHECK_EQUAL(reboot.writeFixed(0, 123449L, 3), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(0, "123.449"));
+
+  reboot.resetDisplay(0);
+  CHECK_EQUAL(reboot.writeFixed(0, 5, 2, '0'), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(0, "0000.05"));
+
+  // Rounding to nothing drops the minus sign, which makes room for a decimal
+  reboot.resetDisplay(2);
+  CHECK_EQUAL(reboot.writeFixed(2, -4L, 2), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(2, "0.0"));
+
+  // More decimals than a long has digits
+  reboot.resetDisplay(2);
+  CHECK_EQUAL(reboot.writeFixed(2, 2147483647L, 20), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(2, "0.0"));
+
+  reboot.resetDisplay(2);
+  CHECK_EQUAL(reboot.writeFixed(2, -2147483647L - 1, 9), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(2, "-2"));
+
+  // Too big even without decimals
+  CHECK_EQUAL(reboot.writeFixed(2, 1234L, 1), GHOSTLAB42REBOOT_ERROR_OVERFLOW);
+
+  // The double overload rounds the same way as the long one
+  reboot.resetDisplay(1);
+  CHECK_EQUAL(reboot.writeFixed(1, 123.449, 3), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(1, "123.4"));
+
+  reboot.resetDisplay(1);
+  CHECK_EQUAL(reboot.writeFixed(1, -123.449, 3), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(1, "-123"));
+
+  reboot.resetDisplay(1);
+  CHECK_EQUAL(reboot.writeFixed(1, 99.996, 3), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(1, "100.0"));
+
+  reboot.resetDisplay(0);
+  CHECK_EQUAL(reboot.writeFixed(0, 0.05, 2, '0'), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(0, "0000.05"));
+
+  // Rounding to negative zero drops the minus sign and keeps the decimal
+  // it makes room for, the same as the long overload
+  reboot.resetDisplay(2);
+  CHECK_EQUAL(reboot.writeFixed(2, -0.04, 2), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(2, "0.0"));
+
+  reboot.resetDisplay(0);
+  CHECK_EQUAL(reboot.writeFixed(0, -0.0004, 3), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(0, "  0.000"));
+
+  reboot.resetDisplay(2);
+  CHECK_EQUAL(reboot.writeFixed(2, -0.0, 1), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(2, "0.0"));
+
+  // Not a number, or too big even without decimals
+  CHECK_EQUAL(reboot.writeFixed(2, 0.0 / 0.0, 1), GHOSTLAB42REBOOT_ERROR_OVERFLOW);
+  CHECK_EQUAL(reboot.writeFixed(2, -12.5, 1), GHOSTLAB42REBOOT_ERROR_OVERFLOW);
+
+  return checkResult();
+}
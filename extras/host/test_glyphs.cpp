@@ -0,0 +1,167 @@
+/*
+ * Compares the glyph table against the if/else chain it replaced, for every
+ * ASCII character with and without a decimal, and how long each one takes
+ * per character
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include <chrono>
+#include "HostTest.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HOST_CYCLES() __rdtsc()
+#endif
+
+static GhostLab42RebootRecordingBus recorder;
+static GhostLab42Reboot reboot(recorder);
+
+// The private encoding is timed directly, without the bus in the way
+class GhostLab42RebootHostAccess
+{
+  public:
+    static byte encodeCharacter(char displayCharacters[], byte glyphs[])
+    {
+      return reboot.encodeCharacter(displayCharacters, glyphs);
+    }
+};
+
+// GhostLab42Reboot::writeCharacter() as it was before the glyph table, with
+// Wire.write() swapped for the glyphs array
+static byte writeCharacter(char displayCharacters[], byte glyphs[])
+{
+  byte count = 0;
+
+  byte decimalOffset = 0x00;
+  if (displayCharacters[1] == '.') decimalOffset = 0x80;
+
+  if      (displayCharacters[0] == '0') glyphs[count++] = 0x3F + decimalOffset;
+  else if (displayCharacters[0] == '1') glyphs[count++] = 0x06 + decimalOffset;
+  else if (displayCharacters[0] == '2') glyphs[count++] = 0x5B + decimalOffset;
+  else if (displayCharacters[0] == '3') glyphs[count++] = 0x4F + decimalOffset;
+  else if (displayCharacters[0] == '4') glyphs[count++] = 0x66 + decimalOffset;
+  else if (displayCharacters[0] == '5') glyphs[count++] = 0x6D + decimalOffset;
+  else if (displayCharacters[0] == '6') glyphs[count++] = 0x7D + decimalOffset;
+  else if (displayCharacters[0] == '7') glyphs[count++] = 0x07 + decimalOffset;
+  else if (displayCharacters[0] == '8') glyphs[count++] = 0x7F + decimalOffset;
+  else if (displayCharacters[0] == '9') glyphs[count++] = 0x6F + decimalOffset;
+
+  else if (displayCharacters[0] == 'A' || displayCharacters[0] == 'a') glyphs[count++] = 0x77 + decimalOffset;
+  else if (displayCharacters[0] == 'B' || displayCharacters[0] == 'b') glyphs[count++] = 0x7C + decimalOffset;
+  else if (displayCharacters[0] == 'C' || displayCharacters[0] == 'c') glyphs[count++] = 0x39 + decimalOffset;
+  else if (displayCharacters[0] == 'D' || displayCharacters[0] == 'd') glyphs[count++] = 0x5E + decimalOffset;
+  else if (displayCharacters[0] == 'E' || displayCharacters[0] == 'e') glyphs[count++] = 0x79 + decimalOffset;
+  else if (displayCharacters[0] == 'F' || displayCharacters[0] == 'f') glyphs[count++] = 0x71 + decimalOffset;
+  else if (displayCharacters[0] == 'G' || displayCharacters[0] == 'g') glyphs[count++] = 0x3D + decimalOffset;
+  else if (displayCharacters[0] == 'H' || displayCharacters[0] == 'h') glyphs[count++] = 0x76 + decimalOffset;
+  else if (displayCharacters[0] == 'I' || displayCharacters[0] == 'i') glyphs[count++] = 0x06 + decimalOffset;
+  else if (displayCharacters[0] == 'J' || displayCharacters[0] == 'j') glyphs[count++] = 0x1E + decimalOffset;
+  else if (displayCharacters[0] == 'K' || displayCharacters[0] == 'k') glyphs[count++] = 0x76 + decimalOffset;
+  else if (displayCharacters[0] == 'L' || displayCharacters[0] == 'l') glyphs[count++] = 0x38 + decimalOffset;
+  else if (displayCharacters[0] == 'M' || displayCharacters[0] == 'm')
+  {
+    glyphs[count++] = 0x33;
+    glyphs[count++] = 0x27 + decimalOffset;
+  }
+  else if (displayCharacters[0] == 'N' || displayCharacters[0] == 'n') glyphs[count++] = 0x54 + decimalOffset;
+  else if (displayCharacters[0] == 'O' || displayCharacters[0] == 'o') glyphs[count++] = 0x3F + decimalOffset;
+  else if (displayCharacters[0] == 'P' || displayCharacters[0] == 'p') glyphs[count++] = 0x73 + decimalOffset;
+  else if (displayCharacters[0] == 'Q' || displayCharacters[0] == 'q') glyphs[count++] = 0x67 + decimalOffset;
+  else if (displayCharacters[0] == 'R' || displayCharacters[0] == 'r') glyphs[count++] = 0x50 + decimalOffset;
+  else if (displayCharacters[0] == 'S' || displayCharacters[0] == 's') glyphs[count++] = 0x6D + decimalOffset;
+  else if (displayCharacters[0] == 'T' || displayCharacters[0] == 't') glyphs[count++] = 0x78 + decimalOffset;
+  else if (displayCharacters[0] == 'U' || displayCharacters[0] == 'u') glyphs[count++] = 0x3E + decimalOffset;
+  else if (displayCharacters[0] == 'V' || displayCharacters[0] == 'v') glyphs[count++] = 0x3E + decimalOffset;
+  else if (displayCharacters[0] == 'W' || displayCharacters[0] == 'w')
+  {
+    glyphs[count++] = 0x3C;
+    glyphs[count++] = 0x1E + decimalOffset;
+  }
+  else if (displayCharacters[0] == 'X' || displayCharacters[0] == 'x') glyphs[count++] = 0x76 + decimalOffset;
+  else if (displayCharacters[0] == 'Y' || displayCharacters[0] == 'y') glyphs[count++] = 0x6E + decimalOffset;
+  else if (displayCharacters[0] == 'Z' || displayCharacters[0] == 'z') glyphs[count++] = 0x5B + decimalOffset;
+
+  else if (displayCharacters[0] == '?') glyphs[count++] = 0xA3;
+  else if (displayCharacters[0] == '!') glyphs[count++] = 0x82;
+  else if (displayCharacters[0] == '-') glyphs[count++] = 0x40;
+  else if (displayCharacters[0] == ' ') glyphs[count++] = 0x00 + decimalOffset;
+
+  else glyphs[count++] = 0x00;
+
+  return count;
+}
+
+typedef byte (*Encoder)(char displayCharacters[], byte glyphs[]);
+
+static volatile byte sink;
+
+// Encodes every ASCII character with and without a decimal, over and over,
+// and prints the time per character
+static void benchmark(const char *name, Encoder encode)
+{
+  const int rounds = 20000;
+  const long characters = (long)rounds * 128 * 2;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#ifdef HOST_CYCLES
+  unsigned long long startCycles = HOST_CYCLES();
+#endif
+
+  for (int round = 0; round < rounds; round++)
+  {
+    for (int character = 0; character < 128; character++)
+    {
+      char characters[2] = {(char)character, 0};
+      byte glyphs[2];
+      sink = encode(characters, glyphs) + glyphs[0];
+      characters[1] = '.';
+      sink = encode(characters, glyphs) + glyphs[0];
+    }
+  }
+
+#ifdef HOST_CYCLES
+  double cycles = (double)(HOST_CYCLES() - startCycles) / characters;
+#else
+  double cycles = 0;
+#endif
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / characters;
+
+  printf("%s,%.2f,%.2f\n", name, ns, cycles);
+}
+
+int main()
+{
+  for (int character = 0; character < 128; character++)
+  {
+    for (int decimal = 0; decimal < 2; decimal++)
+    {
+      char characters[2] = {(char)character, (char)(decimal ? '.' : 0)};
+      byte expected[2] = {0, 0};
+      byte actual[2] = {0, 0};
+      byte expectedCount = writeCharacter(characters, expected);
+
+      // The chain dropped the decimal after a dash, the table lights it like
+      // it does for every other glyph
+      if (character == '-' && decimal) expected[0] |= 0x80;
+      byte actualCount = GhostLab42RebootHostAccess::encodeCharacter(characters, actual);
+
+      if (actualCount != expectedCount || memcmp(actual, expected, sizeof(actual)) != 0)
+      {
+        printf("character %d%s: %d digits 0x%02X 0x%02X, expected %d digits 0x%02X 0x%02X\n",
+               character, decimal ? "." : "", actualCount, actual[0], actual[1],
+               expectedCount, expected[0], expected[1]);
+        checkFailures++;
+      }
+    }
+  }
+
+  // The cycle counts are time stamp counter ticks, 0 where there is none
+  // A computer predicts the branches of the chain far better than an AVR, so
+  // these numbers understate what the table saves on the boards
+  printf("encoder,ns_per_character,cycles_per_character\n");
+  benchmark("if_else_chain", writeCharacter);
+  benchmark("glyph_table", GhostLab42RebootHostAccess::encodeCharacter);
+
+  return checkResult();
+}
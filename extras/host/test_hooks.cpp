@@ -0,0 +1,100 @@
+/*
+ * Runs the public functions with the counting hooks, and checks that the API
+ * hooks run exactly once per call without nesting, and that the transaction
+ * hooks run once around every transaction that reaches the bus
+ *
+ * Built with the stats and trace turned on too, so those get compiled and
+ * checked against the hooks
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "HostTest.h"
+
+static SimulatedBus wire;
+static GhostLab42Reboot reboot(wire);
+
+// Checks the hooks around a single public call
+#define CHECK_CALL(call) \
+  do \
+  { \
+    unsigned long apiBegins = hookApiBegins; \
+    size_t sent = wire.log.size(); \
+    unsigned long transactionBegins = hookTransactionBegins; \
+    call; \
+    CHECK_EQUAL(hookApiBegins - apiBegins, 1); \
+    CHECK_EQUAL(hookApiEnds, hookApiBegins); \
+    CHECK_EQUAL(hookTransactionBegins - transactionBegins, wire.log.size() - sent); \
+    CHECK_EQUAL(hookTransactionEnds, hookTransactionBegins); \
+  } \
+  while (0)
+
+int main()
+{
+  CHECK_CALL(reboot.begin());
+  CHECK_CALL(reboot.write(0, "123456"));
+  CHECK_CALL(reboot.write(1, String("12.34")));
+  CHECK_CALL(reboot.write(2, F("ABCD")));
+  CHECK_CALL(reboot.writeNumber(2, -42));
+  CHECK_CALL(reboot.writeFixed(1, 123449L, 3));
+  CHECK_CALL(reboot.writeFixed(1, 2.5, 1));
+  byte segments[] = {0x01, 0x02};
+  CHECK_CALL(reboot.writeSegments(0, segments, sizeof(segments)));
+  CHECK_CALL(reboot.setDisplayBrightness(0, 50));
+  CHECK_CALL(reboot.resetDisplay(0));
+  CHECK_CALL(reboot.beginFrame());
+  CHECK_CALL(reboot.write(1, "9999"));
+  CHECK_CALL(reboot.endFrame());
+  CHECK_CALL(reboot.fadeTo(0, 100, 100));
+  CHECK_CALL(reboot.scroll(1, "HELLO THERE", 10));
+  for (int i = 0; i < 20; i++)
+  {
+    hostMicros += 10000;
+    CHECK_CALL(reboot.update());
+  }
+  CHECK_CALL(reboot.stopScroll(1));
+
+  // Failed attempts are seen by the hooks too, retries included
+  wire.fail(GHOSTLAB42REBOOT_ERROR_NACK_DATA, 2);
+  CHECK_CALL(reboot.write(0, "654321"));
+  CHECK_EQUAL(hookTransactionFailures, 2);
+
+  // A hang replays every display inside the same call
+  wire.fail(GHOSTLAB42REBOOT_ERROR_TIMEOUT);
+  CHECK_CALL(reboot.write(2, "1111"));
+
+  // Async mode sends from update() and flush()
+  CHECK_CALL(reboot.setAsyncMode(true));
+  CHECK_CALL(reboot.write(0, "111111"));
+  CHECK_CALL(reboot.write(1, "2222"));
+  CHECK_CALL(reboot.update());
+  CHECK_CALL(reboot.flush());
+  CHECK_CALL(reboot.setAsyncMode(false));
+
+  // The widgets and the print sink only call into the library once each
+  GhostLab42RebootCounter counter(reboot, 1);
+  CHECK_CALL(counter.set(9998));
+  CHECK_CALL(counter.increment(3));
+  GhostLab42RebootFilter filter(reboot, 2, 2);
+  CHECK_CALL(filter.write(100));
+  CHECK_CALL(reboot.on(0).print("12.5\n"));
+
+  CHECK_EQUAL(hookApiMaxDepth, 1);
+  CHECK_EQUAL(hookApiDepth, 0);
+  CHECK_EQUAL(hookTransactionDepth, 0);
+  CHECK_EQUAL(hookTransactionsOutsideApi, 0);
+
+  // Every transaction the hooks saw was counted in the stats and the trace
+  unsigned long transactions = 0;
+  unsigned long errors = 0;
+  for (int i = 0; i < reboot.getDisplayCount(); i++)
+  {
+    transactions += reboot.stats(i).transactions;
+    errors += reboot.stats(i).errors;
+  }
+  CHECK_EQUAL(transactions, hookTransactionBegins);
+  CHECK_EQUAL(transactions, wire.log.size());
+  CHECK_EQUAL(errors, hookTransactionFailures);
+
+  return checkResult();
+}
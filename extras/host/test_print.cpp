@@ -0,0 +1,53 @@
+/*
+ * Checks that printing a line through on() shows the same digits as
+ * writing it with write()
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "HostTest.h"
+
+static SimulatedBus wire;
+static GhostLab42Reboot reboot(wire);
+
+// Digits on the six digit display
+static void readDigits(byte digits[])
+{
+  for (int i = 0; i < 6; i++) digits[i] = wire.registerValue(0x60, 0x01 + i);
+}
+
+int main()
+{
+  CHECK_EQUAL(reboot.begin(), GHOSTLAB42REBOOT_OK);
+
+  static const char *const lines[] =
+  {
+    "123456", "12.34", "1.2.3.4.5.6.", ".5", "..5", "5..", "W.M.", "-.",
+    "?.!.", " .", "#.5", "~.1", "a#.b", "1234567.8", "12345678.", "AB.CD.EF.GH"
+  };
+
+  for (size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); i++)
+  {
+    byte written[6];
+    byte printed[6];
+
+    reboot.resetDisplay(0);
+    reboot.write(0, lines[i]);
+    readDigits(written);
+
+    reboot.resetDisplay(0);
+    reboot.on(0).print(lines[i]);
+    reboot.on(0).print('\n');
+    readDigits(printed);
+
+    if (memcmp(written, printed, sizeof(written)) != 0)
+    {
+      printf("\"%s\": printed %02X %02X %02X %02X %02X %02X, written %02X %02X %02X %02X %02X %02X\n",
+             lines[i], printed[0], printed[1], printed[2], printed[3], printed[4], printed[5],
+             written[0], written[1], written[2], written[3], written[4], written[5]);
+      checkFailures++;
+    }
+  }
+
+  return checkResult();
+}
@@ -0,0 +1,98 @@
+/*
+ * Checks that a board that stops answering comes back once it is plugged in
+ * again, through update() or through the next write when update() is never
+ * called
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "HostTest.h"
+
+int main()
+{
+  SimulatedBus wire;
+  GhostLab42Reboot reboot(wire);
+
+  // The four digit display is missing from the start
+  wire.unplug(0x63);
+  CHECK_EQUAL(reboot.begin(), GHOSTLAB42REBOOT_ERROR_NOT_PRESENT);
+  CHECK(reboot.isPresent(2) == false);
+
+  // Writes only go to the shadow copy, without touching the bus
+  size_t sent = wire.log.size();
+  CHECK_EQUAL(reboot.write(2, "1234"), GHOSTLAB42REBOOT_ERROR_NOT_PRESENT);
+  CHECK_EQUAL(reboot.setDisplayBrightness(2, 50), GHOSTLAB42REBOOT_ERROR_NOT_PRESENT);
+  CHECK_EQUAL(wire.log.size(), sent);
+
+  // Plugged in, but it is not looked for again until the interval is up
+  wire.plugIn(0x63);
+  hostMicros += (GHOSTLAB42REBOOT_PROBE_INTERVAL - 1) * 1000UL;
+  CHECK_EQUAL(reboot.write(2, "5678"), GHOSTLAB42REBOOT_ERROR_NOT_PRESENT);
+  CHECK_EQUAL(wire.log.size(), sent);
+
+  // Without update(), the next write finds it and brings it back with the
+  // new digits already in the shadow copy: the probe, the power setting,
+  // every data register with the update in a single burst, and the
+  // brightness, and nothing after that
+  hostMicros += 1000;
+  CHECK_EQUAL(reboot.write(2, "4321"), GHOSTLAB42REBOOT_OK);
+  CHECK(reboot.isPresent(2));
+  CHECK_EQUAL(wire.log.size(), sent + 4);
+  CHECK_EQUAL(wire.log[sent].data.size(), 0);
+  CHECK_EQUAL(wire.log[sent + 1].data[0], 0x0D);
+  CHECK_EQUAL(wire.log[sent + 2].data[0], 0x01);
+  CHECK_EQUAL(wire.log[sent + 2].data.size(), 1 + GHOSTLAB42REBOOT_DATA_REGISTERS + 1);
+  CHECK_EQUAL(wire.log[sent + 2].data[1], 0x66);
+  CHECK_EQUAL(wire.log[sent + 3].data[0], 0x19);
+  CHECK_EQUAL(wire.registerValue(0x63, 0x01), 0x66);
+  CHECK_EQUAL(wire.registerValue(0x63, 0x04), 0x06);
+  CHECK_EQUAL(wire.count(0x63, 0x01), 1);
+
+  // The same goes for the brightness, which goes out with the rest instead
+  // of after it
+  wire.unplug(0x63);
+  CHECK_EQUAL(reboot.write(2, "1111"), GHOSTLAB42REBOOT_ERROR_NACK_ADDRESS);
+  wire.plugIn(0x63);
+  hostMicros += GHOSTLAB42REBOOT_PROBE_INTERVAL * 1000UL;
+  sent = wire.log.size();
+  CHECK_EQUAL(reboot.setDisplayBrightness(2, 20), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log.size(), sent + 4);
+  CHECK_EQUAL(wire.log[sent + 3].data[0], 0x19);
+  CHECK_EQUAL(wire.registerValue(0x63, 0x01), 0x06);
+  reboot.setDisplayBrightness(2, 100);
+
+  // A reset finds it too, and goes out after it has been brought back blank
+  wire.unplug(0x63);
+  CHECK_EQUAL(reboot.write(2, "2222"), GHOSTLAB42REBOOT_ERROR_NACK_ADDRESS);
+  wire.plugIn(0x63);
+  hostMicros += GHOSTLAB42REBOOT_PROBE_INTERVAL * 1000UL;
+  sent = wire.log.size();
+  CHECK_EQUAL(reboot.resetDisplay(2), GHOSTLAB42REBOOT_OK);
+  for (size_t i = sent; i < wire.log.size(); i++)
+  {
+    if (wire.log[i].data.size() > 1 && wire.log[i].data[0] == 0x01) CHECK_EQUAL(wire.log[i].data[1], 0x00);
+  }
+  CHECK_EQUAL(wire.registerValue(0x63, 0x01), 0x00);
+  CHECK_EQUAL(wire.registerValue(0x63, 0xFF), 0x00);
+
+  // A single missed address drops the board, and update() brings it back
+  wire.unplug(0x63);
+  CHECK_EQUAL(reboot.write(2, "1111"), GHOSTLAB42REBOOT_ERROR_NACK_ADDRESS);
+  CHECK(reboot.isPresent(2) == false);
+  wire.plugIn(0x63);
+  hostMicros += GHOSTLAB42REBOOT_PROBE_INTERVAL * 1000UL;
+  CHECK_EQUAL(reboot.update(), GHOSTLAB42REBOOT_OK);
+  CHECK(reboot.isPresent(2));
+  CHECK_EQUAL(wire.registerValue(0x63, 0x01), 0x06);
+
+  // The probe interval is shared, so a write right after does not probe
+  // again even for another board
+  wire.unplug(0x61);
+  CHECK_EQUAL(reboot.write(1, "2222"), GHOSTLAB42REBOOT_ERROR_NACK_ADDRESS);
+  wire.plugIn(0x61);
+  sent = wire.log.size();
+  CHECK_EQUAL(reboot.write(1, "3333"), GHOSTLAB42REBOOT_ERROR_NOT_PRESENT);
+  CHECK_EQUAL(wire.log.size(), sent);
+
+  return checkResult();
+}
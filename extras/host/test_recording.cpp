@@ -0,0 +1,73 @@
+/*
+ * Runs the library against the recording bus and checks what goes out on
+ * the wire for the common calls
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "HostTest.h"
+
+int main()
+{
+  GhostLab42RebootRecordingBus recorder;
+  GhostLab42Reboot reboot(recorder);
+
+  // begin() probes each board and sets its current limit
+  CHECK_EQUAL(reboot.begin(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(reboot.getDisplayCount(), 3);
+  CHECK_EQUAL(recorder.transactionCount(), 6);
+  for (int i = 0; i < 3; i++)
+  {
+    CHECK(reboot.isPresent(i));
+    CHECK_EQUAL(recorder.record(i).length, 0);
+    CHECK_EQUAL(recorder.record(3 + i).data[0], 0x0D);
+  }
+
+  // By default the current limit goes out again ahead of every write
+  recorder.clear();
+  CHECK_EQUAL(reboot.write(2, "5678"), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(recorder.transactionCount(), 2);
+  CHECK_EQUAL(recorder.record(0).data[0], 0x0D);
+  CHECK_EQUAL(recorder.record(1).data[0], 0x01);
+
+  // Leave it at the current limit from begin() for the rest
+  recorder.clear();
+  CHECK_EQUAL(reboot.begin(POWER_ASSERT_ON_ERROR), GHOSTLAB42REBOOT_OK);
+
+  // The first write sends every data register and the Update Column Register
+  // in a single burst
+  recorder.clear();
+  CHECK_EQUAL(reboot.write(1, "1234"), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(recorder.transactionCount(), 1);
+  CHECK_EQUAL(recorder.byteCount(), 1 + GHOSTLAB42REBOOT_DATA_REGISTERS + 1);
+  CHECK_EQUAL(recorder.record(0).address, 0x61);
+  CHECK_EQUAL(recorder.record(0).data[0], 0x01);
+
+  // Writing the same thing again does not go on the wire
+  recorder.clear();
+  CHECK_EQUAL(reboot.write(1, "1234"), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(recorder.transactionCount(), 0);
+
+  // Changing the last digit only sends from its register onwards
+  recorder.clear();
+  CHECK_EQUAL(reboot.write(1, "1235"), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(recorder.transactionCount(), 1);
+  CHECK(recorder.byteCount() < 1 + GHOSTLAB42REBOOT_DATA_REGISTERS + 1);
+  const GhostLab42RebootRecordingBus::Record &record = recorder.record(0);
+  CHECK_EQUAL(record.data[record.length - 1], 0x00);
+
+  // Brightness is a single write to the PWM Register
+  recorder.clear();
+  CHECK_EQUAL(reboot.setDisplayBrightness(0, 2), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(recorder.transactionCount(), 1);
+  CHECK_EQUAL(recorder.byteCount(), 2);
+  CHECK_EQUAL(recorder.record(0).address, 0x60);
+  CHECK_EQUAL(recorder.record(0).data[0], 0x19);
+
+  // Bad display IDs never reach the bus
+  recorder.clear();
+  CHECK_EQUAL(reboot.write(7, "1"), GHOSTLAB42REBOOT_ERROR_INVALID_DISPLAY);
+  CHECK_EQUAL(recorder.transactionCount(), 0);
+
+  return checkResult();
+}
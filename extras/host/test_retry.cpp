@@ -0,0 +1,65 @@
+/*
+ * Checks the waits between retries, including ones too long for
+ * delayMicroseconds(), and that a reset that does not go through leaves the
+ * shadow copy alone
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "HostTest.h"
+
+int main()
+{
+  SimulatedBus wire;
+  GhostLab42Reboot reboot(wire);
+  CHECK_EQUAL(reboot.begin(POWER_ASSERT_ON_ERROR), GHOSTLAB42REBOOT_OK);
+
+  // Every retry waits twice as long as the one before
+  reboot.setRetryPolicy(2, 20000);
+  wire.fail(GHOSTLAB42REBOOT_ERROR_NACK_DATA, 3);
+  size_t sent = wire.log.size();
+  CHECK_EQUAL(reboot.setDisplayBrightness(0, 50), GHOSTLAB42REBOOT_ERROR_NACK_DATA);
+  CHECK_EQUAL(wire.log.size(), sent + 3);
+  CHECK_EQUAL(wire.log[sent + 1].start - wire.log[sent].end, 20000);
+  CHECK_EQUAL(wire.log[sent + 2].start - wire.log[sent + 1].end, 40000);
+
+  // The number of retries is capped, which keeps the longest wait within an
+  // unsigned long
+  reboot.setRetryPolicy(255, 65535);
+  wire.fail(GHOSTLAB42REBOOT_ERROR_NACK_DATA, 1 + GHOSTLAB42REBOOT_MAX_RETRIES);
+  sent = wire.log.size();
+  CHECK_EQUAL(reboot.setDisplayBrightness(0, 50), GHOSTLAB42REBOOT_ERROR_NACK_DATA);
+  CHECK_EQUAL(wire.log.size(), sent + 1 + GHOSTLAB42REBOOT_MAX_RETRIES);
+  CHECK_EQUAL(wire.log.back().start - wire.log[sent + GHOSTLAB42REBOOT_MAX_RETRIES - 1].end,
+              65535UL << (GHOSTLAB42REBOOT_MAX_RETRIES - 1));
+
+  reboot.setRetryPolicy(GHOSTLAB42REBOOT_RETRIES, GHOSTLAB42REBOOT_RETRY_BACKOFF);
+
+  // A reset that fails leaves the display showing what it was, and the
+  // shadow copy agrees, so the next write is built on top of it
+  CHECK_EQUAL(reboot.write(1, "1234"), GHOSTLAB42REBOOT_OK);
+  wire.fail(GHOSTLAB42REBOOT_ERROR_NACK_DATA, 1 + GHOSTLAB42REBOOT_RETRIES);
+  CHECK_EQUAL(reboot.resetDisplay(1), GHOSTLAB42REBOOT_ERROR_NACK_DATA);
+  CHECK_EQUAL(reboot.write(1, "5"), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.registerValue(0x61, 0x01), 0x6D);
+  CHECK_EQUAL(wire.registerValue(0x61, 0x02), 0x5B);
+  CHECK_EQUAL(wire.registerValue(0x61, 0x04), 0x66);
+
+  // Same for a failed reset write after the power went through
+  reboot.setRetryPolicy(0, 0);
+  CHECK_EQUAL(reboot.resetDisplay(1), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(reboot.write(1, "1234"), GHOSTLAB42REBOOT_OK);
+  wire.fail(GHOSTLAB42REBOOT_ERROR_NACK_DATA);
+  CHECK_EQUAL(reboot.resetDisplay(1), GHOSTLAB42REBOOT_ERROR_NACK_DATA);
+  CHECK_EQUAL(reboot.write(1, "5"), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.registerValue(0x61, 0x02), 0x5B);
+
+  // A reset that goes through blanks the shadow copy too
+  CHECK_EQUAL(reboot.resetDisplay(1), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.registerValue(0x61, 0xFF), 0x00);
+  CHECK_EQUAL(reboot.write(1, "5"), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.registerValue(0x61, 0x01), 0x6D);
+  CHECK_EQUAL(wire.registerValue(0x61, 0x02), 0x00);
+
+  return checkResult();
+}
@@ -0,0 +1,115 @@
+/*
+ * Checks the window scroll() moves across the encoded text: one digit per
+ * step, blanks past the end, starting over once it has gone all the way
+ * across, and the same digits as write() for decimals and M/W
+ *
+ * Built with GHOSTLAB42REBOOT_SCROLL_LENGTH at its 255 digit limit
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "HostTest.h"
+
+static SimulatedBus wire;
+static GhostLab42Reboot reboot(wire);
+
+static const byte addresses[] = {0x60, 0x61, 0x63};
+
+// Whether the display shows the same digits as after writing the text
+static bool shows(int displayID, const char *text)
+{
+  byte shown[GHOSTLAB42REBOOT_DATA_REGISTERS];
+  byte address = addresses[displayID];
+  for (int i = 0; i < GHOSTLAB42REBOOT_DATA_REGISTERS; i++) shown[i] = wire.registerValue(address, 0x01 + i);
+
+  reboot.resetDisplay(displayID);
+  reboot.write(displayID, text);
+  bool same = true;
+  for (int i = 0; i < GHOSTLAB42REBOOT_DATA_REGISTERS; i++)
+  {
+    if (wire.registerValue(address, 0x01 + i) != shown[i]) same = false;
+  }
+  if (same == false)
+  {
+    printf("display %d does not show \"%s\":", displayID, text);
+    for (int i = 0; i < GHOSTLAB42REBOOT_DATA_REGISTERS; i++) printf(" %02X", shown[i]);
+    printf("\n");
+  }
+  return same;
+}
+
+// Moves the clock along by one step and lets the scroll take it
+static void step(unsigned long msPerStep)
+{
+  hostMicros += msPerStep * 1000;
+  reboot.update();
+}
+
+int main()
+{
+  CHECK_EQUAL(reboot.begin(POWER_ASSERT_ON_ERROR), GHOSTLAB42REBOOT_OK);
+
+  // The first step shows right away, and nothing moves until the next one is
+  // due
+  CHECK_EQUAL(reboot.scroll(1, "123456", 100), GHOSTLAB42REBOOT_OK);
+  CHECK(reboot.isScrolling(1));
+  size_t sent = wire.log.size();
+  hostMicros += 50000;
+  CHECK_EQUAL(reboot.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log.size(), sent);
+  CHECK(shows(1, "1234"));
+
+  // One digit per step, blank past the end of the text, then back to the
+  // start
+  const char *windows[] = {"2345", "3456", "456", "56", "6", "1234", "2345"};
+  for (size_t i = 0; i < sizeof(windows) / sizeof(windows[0]); i++)
+  {
+    step(100);
+    CHECK(shows(1, windows[i]));
+  }
+
+  // Decimals stay with the digit in front of them
+  CHECK_EQUAL(reboot.scroll(1, "1.2.3.4.5.", 100), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(1, "1.2.3.4."));
+  step(100);
+  CHECK(shows(1, "2.3.4.5."));
+  step(100);
+  CHECK(shows(1, "3.4.5."));
+
+  // M and W take two digits each, and the window moves through the middle
+  // of them
+  byte mw[GHOSTLAB42REBOOT_DATA_REGISTERS];
+  CHECK_EQUAL(reboot.scroll(1, "MW1", 100), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(1, "MW"));
+  for (int i = 0; i < 4; i++) mw[i] = wire.registerValue(0x61, 0x01 + i);
+  step(100);
+  CHECK_EQUAL(wire.registerValue(0x61, 0x01), mw[1]);
+  CHECK_EQUAL(wire.registerValue(0x61, 0x02), mw[2]);
+  CHECK_EQUAL(wire.registerValue(0x61, 0x03), mw[3]);
+  CHECK_EQUAL(wire.registerValue(0x61, 0x04), 0x06);
+  for (int i = 0; i < 4; i++) step(100);
+  CHECK(shows(1, "MW"));
+
+  // Stopping leaves the display alone
+  CHECK_EQUAL(reboot.stopScroll(1), GHOSTLAB42REBOOT_OK);
+  CHECK(reboot.isScrolling(1) == false);
+  sent = wire.log.size();
+  step(100);
+  CHECK_EQUAL(wire.log.size(), sent);
+
+  // Near the end of a full length scroll the window runs past 255, and has
+  // to come up blank rather than wrap around to the start of the text
+  char text[GHOSTLAB42REBOOT_SCROLL_LENGTH + 1];
+  for (int i = 0; i < GHOSTLAB42REBOOT_SCROLL_LENGTH; i++) text[i] = '0' + (i % 10);
+  text[GHOSTLAB42REBOOT_SCROLL_LENGTH] = '\0';
+  CHECK_EQUAL(reboot.scroll(0, text, 1), GHOSTLAB42REBOOT_OK);
+  for (int i = 0; i < GHOSTLAB42REBOOT_SCROLL_LENGTH - 3; i++) step(1);
+  CHECK(shows(0, "234"));
+  step(1);
+  step(1);
+  CHECK(shows(0, "4"));
+  step(1);
+  CHECK(shows(0, "012345"));
+
+  return checkResult();
+}
@@ -0,0 +1,75 @@
+/*
+ * Measures how far apart the three Reboot boards change when they are all
+ * written to, with and without a frame, on a simulated 100kHz bus
+ *
+ * A board changes when its Update Column Register write finishes, so the
+ * skew is the time between the first and the last of those
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "HostTest.h"
+
+// Whether the transaction wrote to the Update Column Register
+static bool updatesColumns(const SimulatedBus::Transaction &transaction)
+{
+  if (transaction.data.size() < 2) return false;
+  byte first = transaction.data[0];
+  byte last = first + transaction.data.size() - 2;
+  return (first <= 0x0C && last >= 0x0C);
+}
+
+// Microseconds between the first and the last board changing since the
+// transaction at the index
+static long measureSkew(SimulatedBus &wire, size_t from, int expectedUpdates)
+{
+  unsigned long first = 0;
+  unsigned long last = 0;
+  int updates = 0;
+  for (size_t i = from; i < wire.log.size(); i++)
+  {
+    if (updatesColumns(wire.log[i]) == false) continue;
+    if (updates++ == 0) first = wire.log[i].end;
+    last = wire.log[i].end;
+  }
+  CHECK_EQUAL(updates, expectedUpdates);
+  return last - first;
+}
+
+static void writeAll(GhostLab42Reboot &reboot, const char *six, const char *four)
+{
+  CHECK_EQUAL(reboot.write(0, six), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(reboot.write(1, four), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(reboot.write(2, four), GHOSTLAB42REBOOT_OK);
+}
+
+int main()
+{
+  SimulatedBus wire(100000);
+  GhostLab42Reboot reboot(wire);
+  CHECK_EQUAL(reboot.begin(), GHOSTLAB42REBOOT_OK);
+
+  // One write after another, each with its own current limit and update
+  size_t from = wire.log.size();
+  writeAll(reboot, "123456", "1234");
+  long separateSkew = measureSkew(wire, from, 3);
+
+  // In a frame, only the three Update Column Register writes go out at the end
+  from = wire.log.size();
+  reboot.beginFrame();
+  writeAll(reboot, "654321", "4321");
+  size_t loaded = wire.log.size();
+  CHECK_EQUAL(reboot.endFrame(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log.size(), loaded + 3);
+  long frameSkew = measureSkew(wire, from, 3);
+
+  // Two more 2 byte transactions after the first board changes
+  CHECK_EQUAL(frameSkew, 2 * wire.wireTime(2));
+  CHECK(frameSkew < separateSkew);
+
+  printf("mode,skew_us\n");
+  printf("separate_writes,%ld\n", separateSkew);
+  printf("frame,%ld\n", frameSkew);
+
+  return checkResult();
+}
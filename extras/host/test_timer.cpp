@@ -0,0 +1,167 @@
+/*
+ * Checks GhostLab42RebootTimer against the simulated bus and the stub
+ * millis(): ticks stay on their absolute deadlines however late update() is,
+ * stop() and resume() keep the part of a second that had passed, a countdown
+ * stops at 0, the hours stop at 99, and each tick only sends the digits from
+ * the first one that changed
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "HostTest.h"
+#include "GhostLab42RebootTimer.h"
+
+static SimulatedBus wire;
+static GhostLab42Reboot reboot(wire);
+
+static const byte addresses[] = {0x60, 0x61, 0x63};
+
+// Whether the display shows the same digits as after writing the text
+static bool shows(int displayID, const char *text)
+{
+  byte shown[GHOSTLAB42REBOOT_DATA_REGISTERS];
+  byte address = addresses[displayID];
+  for (int i = 0; i < GHOSTLAB42REBOOT_DATA_REGISTERS; i++) shown[i] = wire.registerValue(address, 0x01 + i);
+
+  reboot.resetDisplay(displayID);
+  reboot.write(displayID, text);
+  bool same = true;
+  for (int i = 0; i < GHOSTLAB42REBOOT_DATA_REGISTERS; i++)
+  {
+    if (wire.registerValue(address, 0x01 + i) != shown[i]) same = false;
+  }
+  if (same == false)
+  {
+    printf("display %d does not show \"%s\":", displayID, text);
+    for (int i = 0; i < GHOSTLAB42REBOOT_DATA_REGISTERS; i++) printf(" %02X", shown[i]);
+    printf("\n");
+  }
+  return same;
+}
+
+// Moves the stub clock to a number of milliseconds after the start, which
+// only ever goes forward by more than the time the bus took
+static unsigned long startTime;
+
+static void at(unsigned long ms)
+{
+  hostMicros = startTime + ms * 1000;
+}
+
+int main()
+{
+  CHECK_EQUAL(reboot.begin(POWER_ASSERT_ON_ERROR), GHOSTLAB42REBOOT_OK);
+
+  // A stopwatch shows the time right away
+  GhostLab42RebootTimer stopwatch(reboot, 0, TIMER_STOPWATCH);
+  startTime = hostMicros;
+  CHECK_EQUAL(stopwatch.start(), GHOSTLAB42REBOOT_OK);
+  CHECK(stopwatch.isRunning());
+  CHECK(shows(0, "00.00.00"));
+
+  // Nothing happens until the first second is up
+  at(999);
+  size_t sent = wire.log.size();
+  CHECK_EQUAL(stopwatch.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log.size(), sent);
+
+  // A late update() does not push the next tick back
+  at(1300);
+  CHECK_EQUAL(stopwatch.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(stopwatch.getSeconds(), 1);
+  at(1999);
+  CHECK_EQUAL(stopwatch.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(stopwatch.getSeconds(), 1);
+  at(2000);
+  sent = wire.log.size();
+  CHECK_EQUAL(stopwatch.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(stopwatch.getSeconds(), 2);
+
+  // Only the last digit changed, so only it goes out, with the update
+  CHECK_EQUAL(wire.log.size(), sent + 1);
+  CHECK_EQUAL(wire.log.back().data[0], 0x06);
+  CHECK_EQUAL(wire.log.back().data.size(), 1 + 6 + 1);
+  CHECK(shows(0, "00.00.02"));
+
+  // Several seconds without update() catch up in a single write
+  at(9000);
+  sent = wire.log.size();
+  CHECK_EQUAL(stopwatch.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(stopwatch.getSeconds(), 9);
+  CHECK_EQUAL(wire.log.size(), sent + 1);
+
+  // Carrying into the tens of seconds sends from that digit
+  at(10000);
+  CHECK_EQUAL(stopwatch.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log.back().data[0], 0x05);
+  CHECK(shows(0, "00.00.10"));
+
+  // Stopped half way through a second, it picks up with the other half
+  at(10500);
+  stopwatch.stop();
+  CHECK(stopwatch.isRunning() == false);
+  at(20000);
+  sent = wire.log.size();
+  CHECK_EQUAL(stopwatch.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log.size(), sent);
+  CHECK_EQUAL(stopwatch.resume(), GHOSTLAB42REBOOT_OK);
+  CHECK(stopwatch.isRunning());
+  at(20499);
+  CHECK_EQUAL(stopwatch.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(stopwatch.getSeconds(), 10);
+  at(20500);
+  CHECK_EQUAL(stopwatch.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(stopwatch.getSeconds(), 11);
+
+  // The hours only have two digits, so the stopwatch stops at 99.59.59
+  CHECK_EQUAL(stopwatch.start(99UL * 3600 + 59 * 60 + 58), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(0, "99.59.58"));
+  at(22000);
+  CHECK_EQUAL(stopwatch.update(), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(0, "99.59.59"));
+  CHECK(stopwatch.isRunning() == false);
+  at(30000);
+  CHECK_EQUAL(stopwatch.resume(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(stopwatch.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(stopwatch.getSeconds(), 99UL * 3600 + 59 * 60 + 59);
+  CHECK_EQUAL(stopwatch.start(1000000), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(stopwatch.getSeconds(), 99UL * 3600 + 59 * 60 + 59);
+  CHECK(stopwatch.isRunning() == false);
+
+  // A countdown stops at 0 and stays there
+  GhostLab42RebootTimer countdown(reboot, 2, TIMER_COUNTDOWN);
+  startTime = hostMicros;
+  CHECK_EQUAL(countdown.start(2), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(2, "00.02"));
+  at(1000);
+  CHECK_EQUAL(countdown.update(), GHOSTLAB42REBOOT_OK);
+  CHECK(countdown.isExpired() == false);
+  at(2000);
+  CHECK_EQUAL(countdown.update(), GHOSTLAB42REBOOT_OK);
+  CHECK(countdown.isExpired());
+  CHECK(countdown.isRunning() == false);
+  CHECK(shows(2, "00.00"));
+  at(5000);
+  sent = wire.log.size();
+  CHECK_EQUAL(countdown.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(countdown.resume(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(wire.log.size(), sent);
+  CHECK_EQUAL(countdown.getSeconds(), 0);
+
+  // Started from more than the hours have room for, it starts from 99.59.59
+  CHECK_EQUAL(countdown.start(1000000), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(countdown.getSeconds(), 99UL * 3600 + 59 * 60 + 59);
+  CHECK(shows(2, "99.59"));
+
+  // A clock rolls over at midnight
+  GhostLab42RebootTimer clock(reboot, 1, TIMER_CLOCK);
+  startTime = hostMicros;
+  CHECK_EQUAL(clock.start(86399), GHOSTLAB42REBOOT_OK);
+  CHECK(shows(1, "23.59"));
+  at(1000);
+  CHECK_EQUAL(clock.update(), GHOSTLAB42REBOOT_OK);
+  CHECK_EQUAL(clock.getSeconds(), 0);
+  CHECK(shows(1, "00.00"));
+
+  return checkResult();
+}
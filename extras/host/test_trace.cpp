@@ -0,0 +1,133 @@
+/*
+ * Dumps the trace with dumpTrace() and runs it through tracereplay, and
+ * checks that the bus utilization and the redundant Lighting Effect Register
+ * writes it reports agree with what went out on the simulated bus
+ *
+ * Built with the trace turned on, and run with the path to tracereplay
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include "HostTest.h"
+
+static SimulatedBus wire;
+static GhostLab42Reboot reboot(wire);
+
+// Writes everything printed to it into a file
+class FilePrint : public Print
+{
+  public:
+    FilePrint(FILE *file) : file(file) {}
+
+    size_t write(uint8_t character)
+    {
+      return fwrite(&character, 1, 1, file);
+    }
+
+  private:
+    FILE *file;
+};
+
+int main(int argc, char *argv[])
+{
+  if (argc < 2)
+  {
+    printf("Usage: %s tracereplay\n", argv[0]);
+    return 1;
+  }
+
+  // The current limit goes out before every write, so every one after the
+  // first is redundant until a transaction to the display fails
+  CHECK_EQUAL(reboot.begin(POWER_ASSERT_ALWAYS), GHOSTLAB42REBOOT_OK);
+  reboot.clearTrace();
+  size_t first = wire.log.size();
+  CHECK_EQUAL(reboot.write(0, "123456"), GHOSTLAB42REBOOT_OK);
+  hostMicros += 5000;
+  CHECK_EQUAL(reboot.write(0, "234567"), GHOSTLAB42REBOOT_OK);
+  hostMicros += 5000;
+  CHECK_EQUAL(reboot.write(0, "345678"), GHOSTLAB42REBOOT_OK);
+  hostMicros += 5000;
+  wire.fail(GHOSTLAB42REBOOT_ERROR_NACK_DATA);
+  reboot.write(0, "456789");
+  hostMicros += 5000;
+  CHECK_EQUAL(reboot.write(0, "567890"), GHOSTLAB42REBOOT_OK);
+  CHECK(wire.log.size() - first <= GHOSTLAB42REBOOT_TRACE_LENGTH);
+
+  // What the replay should come up with, from the transactions themselves
+  unsigned long lightingEffectWrites = 0;
+  unsigned long redundantWrites = 0;
+  bool powerSet = false;
+  unsigned long busMicros = 0;
+  for (size_t i = first; i < wire.log.size(); i++)
+  {
+    const SimulatedBus::Transaction &transaction = wire.log[i];
+    busMicros += transaction.end - transaction.start;
+    if (transaction.status != 0)
+    {
+      powerSet = false;
+    }
+    else if (transaction.data.size() > 1 && transaction.data[0] == 0x0D)
+    {
+      lightingEffectWrites++;
+      if (powerSet) redundantWrites++;
+      powerSet = true;
+    }
+  }
+  unsigned long span = wire.log.back().end - wire.log[first].start;
+  CHECK_EQUAL(lightingEffectWrites, 5);
+  CHECK_EQUAL(redundantWrites, 3);
+
+  FILE *file = fopen("test_trace.bin", "wb");
+  CHECK(file != NULL);
+  if (file == NULL) return checkResult();
+  FilePrint out(file);
+  size_t written = reboot.dumpTrace(out);
+  fclose(file);
+  CHECK_EQUAL(written, 12 + (wire.log.size() - first) * 8);
+
+  std::string command = std::string(argv[1]) + " test_trace.bin 100000";
+  FILE *report = popen(command.c_str(), "r");
+  CHECK(report != NULL);
+  if (report == NULL) return checkResult();
+
+  unsigned long reportedTransactions = 0;
+  unsigned long reportedLightingEffectWrites = 0;
+  unsigned long reportedRedundantWrites = 0;
+  double reportedUtilization = -1;
+  char line[256];
+  while (fgets(line, sizeof(line), report) != NULL)
+  {
+    unsigned long transactions;
+    unsigned long probes;
+    unsigned long failed;
+    unsigned long writes;
+    unsigned long redundant;
+    double utilization;
+    if (sscanf(line, " transactions %lu (%lu probes, %lu failed)", &transactions, &probes, &failed) == 3)
+    {
+      reportedTransactions += transactions;
+    }
+    else if (sscanf(line, " lighting effect %lu (%lu redundant)", &writes, &redundant) == 2)
+    {
+      reportedLightingEffectWrites += writes;
+      reportedRedundantWrites += redundant;
+    }
+    else if (sscanf(line, "Bus utilization %lf%%", &utilization) == 1)
+    {
+      reportedUtilization = utilization;
+    }
+  }
+  CHECK_EQUAL(pclose(report), 0);
+
+  CHECK_EQUAL(reportedTransactions, wire.log.size() - first);
+  CHECK_EQUAL(reportedLightingEffectWrites, lightingEffectWrites);
+  CHECK_EQUAL(reportedRedundantWrites, redundantWrites);
+
+  // The tool prints one decimal, and the simulated bus rounds each
+  // transaction down to whole microseconds
+  double utilization = 100.0 * busMicros / span;
+  CHECK(reportedUtilization > utilization - 0.5 && reportedUtilization < utilization + 0.5);
+  CHECK(reportedUtilization < 100);
+
+  return checkResult();
+}
@@ -0,0 +1,279 @@
+/*
+ * Replays a trace written by GhostLab42Reboot::dumpTrace() through a model of
+ * the IS31FL3730 and reports how the bus was used
+ *
+ * Runs on the computer, not the Arduino:
+ *   g++ -std=c++11 -o tracereplay tracereplay.cpp
+ *   ./tracereplay trace.bin [clock speed in Hz, 100000 by default]
+ *
+ * See documentation/developer/trace.md for the format of the trace
+ *
+ * See README.md and LICENSE for more information
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+// IS31FL3730 registers, the same as in GhostLab42Reboot.cpp
+const uint8_t firstDataRegister = 0x01;
+const uint8_t lastDataRegister = 0x0B;
+const uint8_t updateColumnRegister = 0x0C;
+const uint8_t lightingEffectRegister = 0x0D;
+const uint8_t pwmRegister = 0x19;
+const uint8_t resetRegister = 0xFF;
+
+// A single transaction as it was traced
+struct Record
+{
+  uint32_t timestamp;
+  uint8_t address;
+  uint8_t firstRegister;
+  uint8_t length;
+  uint8_t status;
+};
+
+// What one display has been sent, and what the model thinks it is doing
+struct Board
+{
+  unsigned long transactions;
+  unsigned long bytes;
+  unsigned long probes;
+  unsigned long errors;
+  unsigned long dataWrites;
+  unsigned long updates;
+  unsigned long emptyUpdates;
+  unsigned long lightingEffectWrites;
+  unsigned long redundantLightingEffectWrites;
+  unsigned long pwmWrites;
+  unsigned long resets;
+  double busMicros;
+
+  // The current limit has been set since the last reset or failure
+  bool powerSet;
+
+  // Data is waiting in the temporary registers, and when it started arriving
+  bool dataPending;
+  uint32_t firstDataTime;
+
+  // Microseconds from the first data of a frame to the Update Column
+  // Register write that showed it
+  std::vector<double> frameLatencies;
+
+  Board()
+    : transactions(0), bytes(0), probes(0), errors(0), dataWrites(0), updates(0),
+      emptyUpdates(0), lightingEffectWrites(0), redundantLightingEffectWrites(0),
+      pwmWrites(0), resets(0), busMicros(0), powerSet(false), dataPending(false),
+      firstDataTime(0) {}
+};
+
+static uint32_t readLong(const uint8_t *bytes)
+{
+  return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) |
+         ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+/*
+ * Microseconds a transaction keeps the bus busy: the START, the address byte
+ * and every data byte with their acknowledge bits, and the STOP
+ */
+static double busMicros(uint8_t length, unsigned long clockSpeed)
+{
+  return ((1 + length) * 9 + 2) * 1000000.0 / clockSpeed;
+}
+
+/*
+ * Runs a transaction through the model of the display it went to
+ */
+static void replay(Board &board, const Record &record, unsigned long clockSpeed)
+{
+  double duration = busMicros(record.length, clockSpeed);
+  board.transactions++;
+  board.bytes += record.length;
+  board.busMicros += duration;
+
+  // The display may have been unplugged, so nothing it was sent can be
+  // trusted any more
+  if (record.status != 0)
+  {
+    board.errors++;
+    board.powerSet = false;
+    board.dataPending = false;
+    return;
+  }
+
+  if (record.length == 0)
+  {
+    board.probes++;
+    return;
+  }
+
+  // The register index auto-increments for every value after the first
+  uint8_t values = record.length - 1;
+  for (unsigned int i = 0; i < values; i++)
+  {
+    uint8_t registerIndex = record.firstRegister + i;
+    if (registerIndex >= firstDataRegister && registerIndex <= lastDataRegister)
+    {
+      board.dataWrites++;
+      if (board.dataPending == false)
+      {
+        board.dataPending = true;
+        board.firstDataTime = record.timestamp;
+      }
+    }
+    else if (registerIndex == updateColumnRegister)
+    {
+      board.updates++;
+      if (board.dataPending)
+      {
+        board.frameLatencies.push_back((uint32_t)(record.timestamp - board.firstDataTime) + duration);
+        board.dataPending = false;
+      }
+      else
+      {
+        board.emptyUpdates++;
+      }
+    }
+    else if (registerIndex == lightingEffectRegister)
+    {
+      // The library only ever sets the same current limit, so setting it
+      // again before the display could have lost it does nothing
+      board.lightingEffectWrites++;
+      if (board.powerSet) board.redundantLightingEffectWrites++;
+      board.powerSet = true;
+    }
+    else if (registerIndex == pwmRegister)
+    {
+      board.pwmWrites++;
+    }
+    else if (registerIndex == resetRegister)
+    {
+      board.resets++;
+      board.powerSet = false;
+      board.dataPending = false;
+    }
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc < 2)
+  {
+    fprintf(stderr, "Usage: %s trace.bin [clock speed in Hz]\n", argv[0]);
+    return 1;
+  }
+
+  unsigned long clockSpeed = (argc > 2) ? strtoul(argv[2], NULL, 10) : 100000;
+  if (clockSpeed == 0)
+  {
+    fprintf(stderr, "Bad clock speed: %s\n", argv[2]);
+    return 1;
+  }
+
+  FILE *file = fopen(argv[1], "rb");
+  if (file == NULL)
+  {
+    perror(argv[1]);
+    return 1;
+  }
+
+  std::vector<uint8_t> bytes;
+  uint8_t buffer[256];
+  size_t count;
+  while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+  {
+    bytes.insert(bytes.end(), buffer, buffer + count);
+  }
+  fclose(file);
+
+  // Header: "GLTR", version, record size, record count, dropped count
+  if (bytes.size() < 12 || memcmp(&bytes[0], "GLTR", 4) != 0)
+  {
+    fprintf(stderr, "%s is not a GhostLab42Reboot trace\n", argv[1]);
+    return 1;
+  }
+  uint8_t version = bytes[4];
+  uint8_t recordSize = bytes[5];
+  unsigned int recordCount = bytes[6] | (bytes[7] << 8);
+  uint32_t dropped = readLong(&bytes[8]);
+  if (version != 1 || recordSize < 8)
+  {
+    fprintf(stderr, "Unsupported trace version %u (record size %u)\n", version, recordSize);
+    return 1;
+  }
+  if (bytes.size() < 12 + (size_t)recordCount * recordSize)
+  {
+    fprintf(stderr, "Trace is cut off, expected %u records\n", recordCount);
+    return 1;
+  }
+
+  std::map<uint8_t, Board> boards;
+  uint32_t firstTimestamp = 0;
+  uint32_t lastTimestamp = 0;
+  double lastDuration = 0;
+  for (unsigned int i = 0; i < recordCount; i++)
+  {
+    const uint8_t *bytesOfRecord = &bytes[12 + i * recordSize];
+    Record record;
+    record.timestamp = readLong(bytesOfRecord);
+    record.address = bytesOfRecord[4];
+    record.firstRegister = bytesOfRecord[5];
+    record.length = bytesOfRecord[6];
+    record.status = bytesOfRecord[7];
+
+    if (i == 0) firstTimestamp = record.timestamp;
+    lastTimestamp = record.timestamp;
+    lastDuration = busMicros(record.length, clockSpeed);
+
+    replay(boards[record.address], record, clockSpeed);
+  }
+
+  double span = (uint32_t)(lastTimestamp - firstTimestamp) + lastDuration;
+  printf("%u transactions over %.0f us at %lu Hz", recordCount, span, clockSpeed);
+  if (dropped > 0) printf(" (%lu older transactions were written over)", (unsigned long)dropped);
+  printf("\n\n");
+
+  double totalBusMicros = 0;
+  for (std::map<uint8_t, Board>::iterator it = boards.begin(); it != boards.end(); ++it)
+  {
+    const Board &board = it->second;
+    totalBusMicros += board.busMicros;
+
+    printf("Display at 0x%02X\n", it->first);
+    printf("  transactions        %lu (%lu probes, %lu failed)\n",
+           board.transactions, board.probes, board.errors);
+    printf("  bytes               %lu\n", board.bytes);
+    printf("  bus time            %.0f us\n", board.busMicros);
+    printf("  data registers      %lu\n", board.dataWrites);
+    printf("  updates             %lu (%lu with no new data)\n", board.updates, board.emptyUpdates);
+    printf("  lighting effect     %lu (%lu redundant)\n",
+           board.lightingEffectWrites, board.redundantLightingEffectWrites);
+    printf("  pwm                 %lu\n", board.pwmWrites);
+    printf("  resets              %lu\n", board.resets);
+
+    if (board.frameLatencies.empty() == false)
+    {
+      double minimum = board.frameLatencies[0];
+      double maximum = minimum;
+      double total = 0;
+      for (size_t i = 0; i < board.frameLatencies.size(); i++)
+      {
+        double latency = board.frameLatencies[i];
+        if (latency < minimum) minimum = latency;
+        if (latency > maximum) maximum = latency;
+        total += latency;
+      }
+      printf("  frame latency       min %.0f us, avg %.0f us, max %.0f us over %lu frames\n",
+             minimum, total / board.frameLatencies.size(), maximum,
+             (unsigned long)board.frameLatencies.size());
+    }
+    printf("\n");
+  }
+
+  printf("Bus utilization       %.1f%%\n", (span > 0) ? 100.0 * totalBusMicros / span : 0.0);
+  return 0;
+}